@@ -0,0 +1,54 @@
+// aleatorio.cpp: xoshiro128+ em RNG_LANES faixas e semente por splitmix64
+#include "aleatorio.h"
+
+static uint64_t splitmix64(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+void Rng::seed(uint64_t seed) {
+    uint64_t state = seed;
+    for (int lane = 0; lane < RNG_LANES; ++lane) {
+        uint64_t a = splitmix64(state);
+        uint64_t b = splitmix64(state);
+        s0[lane] = static_cast<uint32_t>(a);
+        s1[lane] = static_cast<uint32_t>(a >> 32);
+        s2[lane] = static_cast<uint32_t>(b);
+        s3[lane] = static_cast<uint32_t>(b >> 32);
+        if ((s0[lane] | s1[lane] | s2[lane] | s3[lane]) == 0) s0[lane] = 1; // Estado todo zero não sai do zero
+    }
+    cursor = RNG_LANES;
+}
+
+void Rng::step(uint32_t* out) {
+    for (int lane = 0; lane < RNG_LANES; ++lane) {
+        uint32_t result = s0[lane] + s3[lane];
+        uint32_t t = s1[lane] << 9;
+        s2[lane] ^= s0[lane];
+        s3[lane] ^= s1[lane];
+        s1[lane] ^= s2[lane];
+        s0[lane] ^= s3[lane];
+        s2[lane] ^= t;
+        s3[lane] = (s3[lane] << 11) | (s3[lane] >> 21);
+        out[lane] = result;
+    }
+}
+
+void Rng::fill(uint32_t* out, int count) {
+    int i = 0;
+    for (; i + RNG_LANES <= count; i += RNG_LANES) step(out + i);
+    for (; i < count; ++i) out[i] = next();
+}
+
+void Rng::fillFloats(float* out, int count, float min, float max) {
+    const float scale = (max - min) * (1.0f / 16777216.0f);
+    uint32_t block[RNG_LANES];
+    int i = 0;
+    for (; i + RNG_LANES <= count; i += RNG_LANES) {
+        step(block);
+        for (int lane = 0; lane < RNG_LANES; ++lane) out[i + lane] = min + static_cast<float>(block[lane] >> 8) * scale;
+    }
+    for (; i < count; ++i) out[i] = min + nextFloat() * (max - min);
+}
@@ -0,0 +1,44 @@
+// aleatorio.h: gerador pseudoaleatório pequeno e rápido (xoshiro128+) com semente de 64 bits.
+//
+// Cada GameWorld tem o seu, então mundos com a mesma semente e a mesma entrada evoluem igual, inclusive em
+// threads diferentes. O estado são RNG_LANES geradores xoshiro128+ independentes guardados em SoA: um passo
+// avança todas as faixas de uma vez (laço sem dependência entre faixas, que o compilador vetoriza) e produz
+// RNG_LANES números. Os sorteios avulsos consomem esse bloco; fill() escreve blocos inteiros direto na saída.
+
+#pragma once
+
+#include <cstdint>
+
+const int RNG_LANES = 8;
+
+struct Rng {
+    explicit Rng(uint64_t seed = 1) { this->seed(seed); }
+
+    // Espalha a semente pelas faixas com splitmix64; sementes vizinhas dão sequências sem relação
+    void seed(uint64_t seed);
+
+    uint32_t next() {
+        if (cursor == RNG_LANES) {
+            step(buffer);
+            cursor = 0;
+        }
+        return buffer[cursor++];
+    }
+
+    // Float em [0, 1) com os 24 bits altos (os bits baixos do xoshiro128+ são os mais fracos)
+    float nextFloat() { return static_cast<float>(next() >> 8) * (1.0f / 16777216.0f); }
+
+    // Inteiro em [0, n) por multiplicação, sem o viés de módulo nos bits baixos
+    uint32_t nextBelow(uint32_t n) { return static_cast<uint32_t>((static_cast<uint64_t>(next()) * n) >> 32); }
+
+    // Sorteios em lote para rajadas de partículas
+    void fill(uint32_t* out, int count);
+    void fillFloats(float* out, int count, float min, float max);
+
+private:
+    void step(uint32_t* out); // Avança todas as faixas e escreve RNG_LANES números
+
+    uint32_t s0[RNG_LANES], s1[RNG_LANES], s2[RNG_LANES], s3[RNG_LANES];
+    uint32_t buffer[RNG_LANES];
+    int cursor = RNG_LANES;
+};
@@ -0,0 +1,108 @@
+// particulas_bench.cpp: micro-benchmark dos kernels de partículas contra os laços glm, com 1k, 10k e 100k partículas.
+//
+// Uso: particulas_bench [passos]
+//   passos: updates medidos por tamanho e kernel (padrão 2000); o tempo sai em ns por partícula por update
+#include "particulas_simd.h"
+
+#include <glm/glm.hpp>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cstdlib>
+#include <cmath>
+#include <algorithm>
+
+// Campos de um sistema de partículas, no mesmo formato do ParticlePool
+struct BenchParticles {
+    std::vector<glm::vec3> position, velocity;
+    std::vector<float> size, lifetime;
+};
+
+BenchParticles makeParticles(int count) {
+    std::minstd_rand rng(7);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    BenchParticles p;
+    for (int i = 0; i < count; ++i) {
+        p.position.push_back(glm::vec3(dist(rng), dist(rng), dist(rng)) * 10.0f);
+        p.velocity.push_back(glm::vec3(dist(rng), dist(rng), dist(rng)));
+        p.size.push_back(0.1f + 0.05f * dist(rng));
+        p.lifetime.push_back(1e6f); // Ninguém morre: mede só a integração
+    }
+    return p;
+}
+
+const float BENCH_DT = 1.0f / 120.0f;
+const float BENCH_DECAY = 1.5f, BENCH_GRAVITY = 5.0f, BENCH_SHRINK = 0.9995f;
+
+// Os laços por glm::vec3 que a simulação usava antes dos kernels
+void updateGlm(BenchParticles& p) {
+    int count = static_cast<int>(p.lifetime.size());
+    for (int i = 0; i < count; ++i) p.lifetime[i] -= BENCH_DECAY * BENCH_DT;
+    for (int i = 0; i < count; ++i) p.position[i] += p.velocity[i] * BENCH_DT;
+    for (int i = 0; i < count; ++i) p.velocity[i].y -= BENCH_GRAVITY * BENCH_DT;
+    for (int i = 0; i < count; ++i) p.size[i] *= BENCH_SHRINK;
+}
+
+void updateKernels(BenchParticles& p, const ParticleKernels& kernels) {
+    int count = static_cast<int>(p.lifetime.size());
+    kernels.age(p.lifetime.data(), count, BENCH_DECAY * BENCH_DT);
+    kernels.integrate(&p.position.data()->x, &p.velocity.data()->x, 3 * count, BENCH_DT);
+    kernels.fall(&p.velocity.data()->x, count, BENCH_GRAVITY * BENCH_DT);
+    kernels.scale(p.size.data(), count, BENCH_SHRINK);
+}
+
+// Maior diferença entre dois resultados, para conferir que os kernels calculam o mesmo que os laços glm
+float maxDifference(const BenchParticles& a, const BenchParticles& b) {
+    float diff = 0.0f;
+    for (size_t i = 0; i < a.lifetime.size(); ++i) {
+        diff = std::max(diff, glm::length(a.position[i] - b.position[i]));
+        diff = std::max(diff, glm::length(a.velocity[i] - b.velocity[i]));
+        diff = std::max(diff, std::abs(a.size[i] - b.size[i]));
+        diff = std::max(diff, std::abs(a.lifetime[i] - b.lifetime[i]) / 1e6f);
+    }
+    return diff;
+}
+
+template <typename Update>
+double nsPerParticle(BenchParticles& p, int steps, Update update) {
+    update(p); // Aquece caches
+    auto begin = std::chrono::steady_clock::now();
+    for (int s = 0; s < steps; ++s) update(p);
+    double elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count();
+    return elapsed / (static_cast<double>(steps) * p.lifetime.size());
+}
+
+int main(int argc, char** argv) {
+    int steps = argc > 1 ? std::atoi(argv[1]) : 2000;
+    if (steps <= 0) {
+        std::cerr << "Uso: " << argv[0] << " [passos]\n";
+        return 1;
+    }
+
+    std::vector<const ParticleKernels*> kernelSets = { &scalarParticleKernels() };
+    if (const ParticleKernels* sse = sseParticleKernels()) kernelSets.push_back(sse);
+    if (const ParticleKernels* avx2 = avx2ParticleKernels()) kernelSets.push_back(avx2);
+    std::cout << "Kernel usado pela simulacao: " << particleKernels().name << "\n";
+
+    const int sizes[] = { 1000, 10000, 100000 };
+    for (int count : sizes) {
+        // Passos menores para 100k, para cada medida levar mais ou menos o mesmo tempo
+        int sizeSteps = std::max(1, static_cast<int>(static_cast<long long>(steps) * 1000 / count));
+        BenchParticles reference = makeParticles(count);
+        double glmNs = nsPerParticle(reference, sizeSteps, updateGlm);
+
+        std::cout << "\n" << count << " particulas (" << sizeSteps << " updates)\n"
+                  << std::fixed << std::setprecision(3)
+                  << "  " << std::setw(8) << "glm" << ": " << glmNs << " ns/particula\n";
+        for (const ParticleKernels* kernels : kernelSets) {
+            BenchParticles p = makeParticles(count);
+            double ns = nsPerParticle(p, sizeSteps, [&](BenchParticles& q) { updateKernels(q, *kernels); });
+            std::cout << "  " << std::setw(8) << kernels->name << ": " << ns << " ns/particula ("
+                      << glmNs / ns << "x), diferenca max " << std::scientific << maxDifference(reference, p)
+                      << std::fixed << "\n";
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,192 @@
+// particulas_simd.cpp: kernels escalar, SSE e AVX2 das partículas e detecção da CPU
+#include "particulas_simd.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define PARTICLES_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// GCC/Clang só geram instruções SSE/AVX2 em funções marcadas com o alvo; o MSVC aceita os intrinsics direto
+#if defined(PARTICLES_X86) && (defined(__GNUC__) || defined(__clang__))
+#define TARGET_SSE __attribute__((target("sse2")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TARGET_SSE
+#define TARGET_AVX2
+#endif
+
+// ================== ESCALAR ==================
+void integrateScalar(float* position, const float* velocity, int floatCount, float deltaTime) {
+    for (int i = 0; i < floatCount; ++i) position[i] += velocity[i] * deltaTime;
+}
+
+void fallScalar(float* velocity, int count, float amount) {
+    for (int i = 0; i < count; ++i) velocity[3 * i + 1] -= amount;
+}
+
+void scaleScalar(float* values, int count, float factor) {
+    for (int i = 0; i < count; ++i) values[i] *= factor;
+}
+
+bool ageScalar(float* lifetime, int count, float amount) {
+    bool died = false;
+    for (int i = 0; i < count; ++i) {
+        lifetime[i] -= amount;
+        died |= lifetime[i] <= 0.0f;
+    }
+    return died;
+}
+
+const ParticleKernels& scalarParticleKernels() {
+    static const ParticleKernels kernels = { "escalar", integrateScalar, fallScalar, scaleScalar, ageScalar };
+    return kernels;
+}
+
+#ifdef PARTICLES_X86
+// ================== SSE (4 floats) ==================
+TARGET_SSE void integrateSSE(float* position, const float* velocity, int floatCount, float deltaTime) {
+    __m128 dt = _mm_set1_ps(deltaTime);
+    int i = 0;
+    for (; i + 4 <= floatCount; i += 4) {
+        __m128 p = _mm_loadu_ps(position + i);
+        __m128 v = _mm_loadu_ps(velocity + i);
+        _mm_storeu_ps(position + i, _mm_add_ps(p, _mm_mul_ps(v, dt)));
+    }
+    integrateScalar(position + i, velocity + i, floatCount - i, deltaTime);
+}
+
+// 4 partículas = 12 floats = 3 registradores; o y cai nas posições 1, 4, 7 e 10 do bloco
+TARGET_SSE void fallSSE(float* velocity, int count, float amount) {
+    const __m128 m0 = _mm_setr_ps(0.0f, amount, 0.0f, 0.0f);
+    const __m128 m1 = _mm_setr_ps(amount, 0.0f, 0.0f, amount);
+    const __m128 m2 = _mm_setr_ps(0.0f, 0.0f, amount, 0.0f);
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        float* v = velocity + 3 * i;
+        _mm_storeu_ps(v, _mm_sub_ps(_mm_loadu_ps(v), m0));
+        _mm_storeu_ps(v + 4, _mm_sub_ps(_mm_loadu_ps(v + 4), m1));
+        _mm_storeu_ps(v + 8, _mm_sub_ps(_mm_loadu_ps(v + 8), m2));
+    }
+    fallScalar(velocity + 3 * i, count - i, amount);
+}
+
+TARGET_SSE void scaleSSE(float* values, int count, float factor) {
+    __m128 f = _mm_set1_ps(factor);
+    int i = 0;
+    for (; i + 4 <= count; i += 4) _mm_storeu_ps(values + i, _mm_mul_ps(_mm_loadu_ps(values + i), f));
+    scaleScalar(values + i, count - i, factor);
+}
+
+TARGET_SSE bool ageSSE(float* lifetime, int count, float amount) {
+    __m128 a = _mm_set1_ps(amount);
+    __m128 zero = _mm_setzero_ps();
+    __m128 dead = zero;
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 l = _mm_sub_ps(_mm_loadu_ps(lifetime + i), a);
+        _mm_storeu_ps(lifetime + i, l);
+        dead = _mm_or_ps(dead, _mm_cmple_ps(l, zero));
+    }
+    bool died = _mm_movemask_ps(dead) != 0;
+    return ageScalar(lifetime + i, count - i, amount) || died;
+}
+
+// ================== AVX2 (8 floats) ==================
+TARGET_AVX2 void integrateAVX2(float* position, const float* velocity, int floatCount, float deltaTime) {
+    __m256 dt = _mm256_set1_ps(deltaTime);
+    int i = 0;
+    for (; i + 8 <= floatCount; i += 8) {
+        __m256 p = _mm256_loadu_ps(position + i);
+        __m256 v = _mm256_loadu_ps(velocity + i);
+        _mm256_storeu_ps(position + i, _mm256_add_ps(p, _mm256_mul_ps(v, dt)));
+    }
+    integrateScalar(position + i, velocity + i, floatCount - i, deltaTime);
+}
+
+// 8 partículas = 24 floats = 3 registradores; o y cai em 1, 4, 7 | 10, 13 | 16, 19, 22
+TARGET_AVX2 void fallAVX2(float* velocity, int count, float amount) {
+    const __m256 m0 = _mm256_setr_ps(0.0f, amount, 0.0f, 0.0f, amount, 0.0f, 0.0f, amount);
+    const __m256 m1 = _mm256_setr_ps(0.0f, 0.0f, amount, 0.0f, 0.0f, amount, 0.0f, 0.0f);
+    const __m256 m2 = _mm256_setr_ps(amount, 0.0f, 0.0f, amount, 0.0f, 0.0f, amount, 0.0f);
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        float* v = velocity + 3 * i;
+        _mm256_storeu_ps(v, _mm256_sub_ps(_mm256_loadu_ps(v), m0));
+        _mm256_storeu_ps(v + 8, _mm256_sub_ps(_mm256_loadu_ps(v + 8), m1));
+        _mm256_storeu_ps(v + 16, _mm256_sub_ps(_mm256_loadu_ps(v + 16), m2));
+    }
+    fallScalar(velocity + 3 * i, count - i, amount);
+}
+
+TARGET_AVX2 void scaleAVX2(float* values, int count, float factor) {
+    __m256 f = _mm256_set1_ps(factor);
+    int i = 0;
+    for (; i + 8 <= count; i += 8) _mm256_storeu_ps(values + i, _mm256_mul_ps(_mm256_loadu_ps(values + i), f));
+    scaleScalar(values + i, count - i, factor);
+}
+
+TARGET_AVX2 bool ageAVX2(float* lifetime, int count, float amount) {
+    __m256 a = _mm256_set1_ps(amount);
+    __m256 zero = _mm256_setzero_ps();
+    __m256 dead = zero;
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 l = _mm256_sub_ps(_mm256_loadu_ps(lifetime + i), a);
+        _mm256_storeu_ps(lifetime + i, l);
+        dead = _mm256_or_ps(dead, _mm256_cmp_ps(l, zero, _CMP_LE_OQ));
+    }
+    bool died = _mm256_movemask_ps(dead) != 0;
+    return ageScalar(lifetime + i, count - i, amount) || died;
+}
+
+// ================== DETECÇÃO DA CPU ==================
+bool cpuHasSSE2() {
+#if defined(_M_X64) || defined(__x86_64__)
+    return true; // Obrigatório no x86-64
+#elif defined(_MSC_VER)
+    int regs[4];
+    __cpuid(regs, 1);
+    return (regs[3] & (1 << 26)) != 0;
+#else
+    return __builtin_cpu_supports("sse2");
+#endif
+}
+
+bool cpuHasAVX2() {
+#ifdef _MSC_VER
+    // AVX2 na CPU e registradores YMM salvos pelo sistema (OSXSAVE + XCR0)
+    int regs[4];
+    __cpuid(regs, 1);
+    bool osSavesYmm = (regs[2] & (1 << 27)) && (regs[2] & (1 << 28)) && (_xgetbv(0) & 6) == 6;
+    __cpuidex(regs, 7, 0);
+    return osSavesYmm && (regs[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+const ParticleKernels* sseParticleKernels() {
+    static const ParticleKernels kernels = { "SSE", integrateSSE, fallSSE, scaleSSE, ageSSE };
+    return cpuHasSSE2() ? &kernels : nullptr;
+}
+
+const ParticleKernels* avx2ParticleKernels() {
+    static const ParticleKernels kernels = { "AVX2", integrateAVX2, fallAVX2, scaleAVX2, ageAVX2 };
+    return cpuHasAVX2() ? &kernels : nullptr;
+}
+#else
+const ParticleKernels* sseParticleKernels() { return nullptr; }
+const ParticleKernels* avx2ParticleKernels() { return nullptr; }
+#endif
+
+const ParticleKernels& particleKernels() {
+    static const ParticleKernels* best = [] {
+        if (const ParticleKernels* avx2 = avx2ParticleKernels()) return avx2;
+        if (const ParticleKernels* sse = sseParticleKernels()) return sse;
+        return &scalarParticleKernels();
+    }();
+    return *best;
+}
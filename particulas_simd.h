@@ -0,0 +1,22 @@
+// particulas_simd.h: kernels de integração das partículas (escalar, SSE e AVX2) com escolha em tempo de execução.
+//
+// Os kernels trabalham direto nos vetores do ParticlePool: posição e velocidade são glm::vec3 contíguos, então
+// viram arrays de 3 * count floats e a integração é uma soma elemento a elemento. A gravidade só mexe no y,
+// que se repete a cada 3 floats; os kernels SIMD aplicam uma máscara com esse padrão.
+
+#pragma once
+
+struct ParticleKernels {
+    const char* name;
+    void (*integrate)(float* position, const float* velocity, int floatCount, float deltaTime); // position += velocity * dt
+    void (*fall)(float* velocity, int count, float amount);         // velocity[i].y -= amount
+    void (*scale)(float* values, int count, float factor);          // values[i] *= factor
+    bool (*age)(float* lifetime, int count, float amount);          // lifetime[i] -= amount; true se alguma chegou a 0
+};
+
+const ParticleKernels& scalarParticleKernels();
+const ParticleKernels* sseParticleKernels();  // nullptr fora de x86 ou sem suporte na CPU
+const ParticleKernels* avx2ParticleKernels(); // nullptr fora de x86 ou sem suporte na CPU
+
+// Melhor conjunto suportado pela CPU, escolhido na primeira chamada
+const ParticleKernels& particleKernels();
@@ -0,0 +1,675 @@
+// simulacao.cpp: lógica do jogo em passo fixo, sem dependência de janela, OpenGL ou ImGui
+#include "simulacao.h"
+#include "particulas_simd.h"
+
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <bitset>
+
+// ================== FUNÇÕES AUXILIARES ==================
+// Gera um float aleatório entre min e max com o gerador do mundo
+float randomFloat(GameWorld& world, float min, float max) {
+    return min + world.rng.nextFloat() * (max - min);
+}
+
+// Inteiro aleatório em [0, n)
+int randomInt(GameWorld& world, int n) {
+    return static_cast<int>(world.rng.nextBelow(static_cast<uint32_t>(n)));
+}
+
+// count floats aleatórios entre min e max de uma vez (rajadas de partículas)
+void randomFloats(GameWorld& world, float* out, int count, float min, float max) {
+    world.rng.fillFloats(out, count, min, max);
+}
+
+// Quantidade base multiplicada por um fator do SimBudget, arredondada
+int scaledCount(int base, float factor) {
+    return std::max(0, static_cast<int>(std::lround(base * factor)));
+}
+
+// ================== PARTÍCULAS ==================
+void ParticlePool::allocate(int newCapacity) {
+    count = 0;
+    epoch++;
+    spawned.clear();
+    spawned.reserve(newCapacity);
+    if (newCapacity == capacity()) return;
+    position.resize(newCapacity);
+    velocity.resize(newCapacity);
+    color.resize(newCapacity);
+    size.resize(newCapacity);
+    lifetime.resize(newCapacity);
+}
+
+bool ParticlePool::emit(const Particle& p) {
+    if (external) {
+        if (static_cast<int>(spawned.size()) >= capacity()) return false;
+        spawned.push_back(p);
+        return true;
+    }
+    if (count >= capacity()) return false;
+    position[count] = p.position;
+    velocity[count] = p.velocity;
+    color[count] = p.color;
+    size[count] = p.size;
+    lifetime[count] = p.lifetime;
+    count++;
+    return true;
+}
+
+// Um kernel por campo (SSE/AVX2 quando a CPU tem), e as mortas saem no fim por swap-and-pop
+static_assert(sizeof(glm::vec3) == 3 * sizeof(float), "os kernels tratam vetores de glm::vec3 como floats contíguos");
+
+void ParticlePool::update(float deltaTime) {
+    if (count == 0) return;
+    const ParticleKernels& kernels = particleKernels();
+    bool died = kernels.age(lifetime.data(), count, decay * deltaTime);
+    kernels.integrate(&position.data()->x, &velocity.data()->x, 3 * count, deltaTime);
+    if (gravity != 0.0f) kernels.fall(&velocity.data()->x, count, gravity * deltaTime);
+    kernels.scale(size.data(), count, perFrameFactor(shrink, deltaTime));
+    if (!died) return;
+
+    // De trás para frente: a última partícula, que vem para o lugar da morta, já foi verificada
+    for (int i = count - 1; i >= 0; --i) {
+        if (lifetime[i] > 0.0f) continue;
+        int last = --count;
+        position[i] = position[last];
+        velocity[i] = velocity[last];
+        color[i] = color[last];
+        size[i] = size[last];
+        lifetime[i] = lifetime[last];
+    }
+}
+
+int particlePoolCapacity(const SimBudget& budget) {
+    return scaledCount(PARTICLE_POOL_CAPACITY, budget.particles);
+}
+
+// Uma onda começa com menos que o limite de aliens e traz até 3 (escalados) de uma vez
+int obstacleCapacity(const SimBudget& budget) {
+    return scaledCount(MAX_OBJECTS, budget.objects) + scaledCount(3, budget.objects);
+}
+
+// Capacidade e evolução de cada sistema (taxas ajustadas a 60 FPS no jogo original)
+void setupParticlePools(GameWorld& world) {
+    int capacity = world.effects ? particlePoolCapacity(world.budget) : 0;
+    ParticlePool* pools[] = { &world.thrusterParticles, &world.collectParticles, &world.speedParticles, &world.explosionParticles };
+    for (ParticlePool* pool : pools) pool->allocate(capacity);
+
+    world.thrusterParticles.decay = 2.0f;
+    world.thrusterParticles.shrink = 0.98f;
+    world.collectParticles.decay = 2.0f;
+    world.collectParticles.gravity = 2.0f;
+    world.collectParticles.shrink = 0.96f;
+    world.speedParticles.decay = 3.0f;
+    world.speedParticles.shrink = 0.95f;
+    world.explosionParticles.decay = 1.5f;
+    world.explosionParticles.gravity = 5.0f;
+    world.explosionParticles.shrink = 0.94f;
+}
+
+void setExternalParticles(GameWorld& world, bool external) {
+    ParticlePool* pools[] = { &world.thrusterParticles, &world.collectParticles, &world.speedParticles, &world.explosionParticles };
+    for (ParticlePool* pool : pools) {
+        pool->external = external;
+        pool->allocate(pool->capacity());
+    }
+}
+
+// ================ LÓGICA DO JOGO ==================
+// Converte um fator aplicado uma vez por frame a 60 FPS (decaimento, suavização) para um passo de dt segundos
+float perFrameFactor(float factor, float dt) {
+    return std::pow(factor, dt * REFERENCE_FPS);
+}
+
+// Abaixo disso o jogador é considerado parado
+bool playerMoving(const GameWorld& world) {
+    return glm::length(world.playerVelocity) > 0.6f;
+}
+
+// Guarda as posições do passo atual antes de simular o próximo
+void savePreviousPositions(GameWorld& world) {
+    world.prevPlayerPos = world.playerPos;
+    for (auto& obs : world.obstacles) obs.prevPosition = obs.position;
+    for (auto& col : world.collectibles) col.prevPosition = col.position;
+}
+
+// Posição de um objeto entre os dois últimos passos (alpha = fração do passo já decorrida)
+glm::vec3 interpolatedPosition(const GameObject& obj, float alpha) {
+    return glm::mix(obj.prevPosition, obj.position, alpha);
+}
+
+// ================== GRADE ESPACIAL ==================
+GameObject& gridObject(GameWorld& world, int handle) {
+    return (handle & GRID_COLLECTIBLE) ? world.collectibles[handle & ~GRID_COLLECTIBLE] : world.obstacles[handle];
+}
+
+const GameObject& gridObject(const GameWorld& world, int handle) {
+    return (handle & GRID_COLLECTIBLE) ? world.collectibles[handle & ~GRID_COLLECTIBLE] : world.obstacles[handle];
+}
+
+int gridBucket(int cellX, int cellZ) {
+    unsigned int h = static_cast<unsigned int>(cellX) * 73856093u ^ static_cast<unsigned int>(cellZ) * 19349663u;
+    return static_cast<int>(h & (GRID_BUCKETS - 1));
+}
+
+int gridCellX(float x) {
+    return static_cast<int>(std::floor(x / GRID_CELL_SIZE));
+}
+
+int gridCellZ(const SpatialGrid& grid, float z) {
+    return static_cast<int>(std::floor((z - grid.scroll) / GRID_CELL_SIZE));
+}
+
+void gridInsert(GameWorld& world, int handle) {
+    GameObject& obj = gridObject(world, handle);
+    obj.gridBucket = gridBucket(gridCellX(obj.position.x), gridCellZ(world.grid, obj.position.z));
+    obj.gridNext = world.grid.heads[obj.gridBucket];
+    world.grid.heads[obj.gridBucket] = handle;
+}
+
+// Troca oldHandle por newHandle na lista do balde (remove quando newHandle = -1)
+void gridReplace(GameWorld& world, int bucket, int oldHandle, int newHandle) {
+    int* link = &world.grid.heads[bucket];
+    while (*link != oldHandle) link = &gridObject(world, *link).gridNext;
+    if (newHandle < 0) *link = gridObject(world, oldHandle).gridNext;
+    else *link = newHandle;
+}
+
+void addObject(GameWorld& world, const GameObject& obj) {
+    bool collectible = obj.type == 1;
+    std::vector<GameObject>& list = collectible ? world.collectibles : world.obstacles;
+    list.push_back(obj);
+    gridInsert(world, static_cast<int>(list.size() - 1) | (collectible ? GRID_COLLECTIBLE : 0));
+}
+
+void removeObject(GameWorld& world, int handle) {
+    bool collectible = (handle & GRID_COLLECTIBLE) != 0;
+    std::vector<GameObject>& list = collectible ? world.collectibles : world.obstacles;
+    int index = handle & ~GRID_COLLECTIBLE;
+    int last = static_cast<int>(list.size() - 1);
+
+    gridReplace(world, list[index].gridBucket, handle, -1);
+    if (index != last) {
+        // O último objeto vai para o lugar do removido: só o handle dele muda na grade
+        int lastHandle = last | (collectible ? GRID_COLLECTIBLE : 0);
+        gridReplace(world, list[last].gridBucket, lastHandle, handle);
+        list[index] = list[last];
+    }
+    list.pop_back();
+}
+
+// Chama visit(handle, objeto) para cada objeto nas células que cobrem o círculo (pos, radius) no plano XZ;
+// o teste de distância fica com quem chama. Para quando visit retorna false.
+template <typename World, typename Visit>
+bool visitNear(World& world, glm::vec3 pos, float radius, Visit visit) {
+    int x0 = gridCellX(pos.x - radius), x1 = gridCellX(pos.x + radius);
+    int z0 = gridCellZ(world.grid, pos.z - radius), z1 = gridCellZ(world.grid, pos.z + radius);
+
+    // Células diferentes podem cair no mesmo balde: cada balde é visitado uma vez só
+    std::bitset<GRID_BUCKETS> visited;
+    for (int cx = x0; cx <= x1; ++cx) {
+        for (int cz = z0; cz <= z1; ++cz) {
+            int bucket = gridBucket(cx, cz);
+            if (visited[bucket]) continue;
+            visited[bucket] = true;
+            for (int handle = world.grid.heads[bucket]; handle >= 0;) {
+                auto& obj = gridObject(world, handle);
+                int next = obj.gridNext;
+                if (!visit(handle, obj)) return false;
+                handle = next;
+            }
+        }
+    }
+    return true;
+}
+
+// Verifica se uma posição está livre para spawn (aparecimento) de objeto
+bool checkPositionFree(const GameWorld& world, glm::vec3 pos, float minDistance) {
+    return visitNear(world, pos, minDistance, [&](int, const GameObject& obj) {
+        return !(obj.active && glm::length(glm::vec2(obj.position.x - pos.x, obj.position.z - pos.z)) < minDistance);
+    });
+}
+
+// Spawna aliens ou moedas no cenário
+void spawnObject(GameWorld& world, int type) {
+    if (type == 0) {
+        // REDUZIDO: 1 a 3 aliens por spawn (menos poluído)
+        int numAliens = scaledCount(1 + randomInt(world, 3), world.budget.objects);
+        float spawnDepth = 6.0f * world.budget.objects; // Mais aliens por onda pedem uma faixa mais funda
+
+        for (int i = 0; i < numAliens; i++) {
+            GameObject obj;
+
+            obj.position.x = randomFloat(world, -8.0f, 8.0f);
+            obj.position.y = randomFloat(world, 0.5f, 1.2f);
+            obj.position.z = randomFloat(world, -32.0f - spawnDepth, -32.0f);
+
+            if (!checkPositionFree(world, obj.position, 1.8f)) continue;
+            obj.prevPosition = obj.position;
+
+            obj.active = true;
+            obj.type = 0;
+
+            // VARIAÇÃO DE TAMANHO: alguns aliens são MUITO maiores!
+            float sizeCategory = randomFloat(world, 0.0f, 1.0f);
+            float scaleVariation;
+
+            if (sizeCategory < 0.6f) {
+                // 60% - aliens normais
+                scaleVariation = randomFloat(world, 0.8f, 1.2f);
+            }
+            else if (sizeCategory < 0.85f) {
+                // 25% - aliens grandes
+                scaleVariation = randomFloat(world, 1.3f, 1.8f);
+            }
+            else {
+                // 15% - aliens GIGANTES!
+                scaleVariation = randomFloat(world, 1.9f, 2.5f);
+            }
+
+            obj.scale = glm::vec3(0.8f * scaleVariation, 1.5f * scaleVariation, 0.8f * scaleVariation);
+            obj.rotation = randomFloat(world, 0.0f, 360.0f);
+
+            obj.color = glm::vec3(
+                randomFloat(world, 0.7f, 0.95f),
+                randomFloat(world, 0.1f, 0.3f),
+                randomFloat(world, 0.1f, 0.2f)
+            );
+
+            addObject(world, obj);
+
+            // Incrementa contador para moedas raras
+            world.alienSpawnCount++;
+        }
+    }
+    else {
+        // MOEDAS RARAS: apenas 1 a cada ~10 aliens
+        if (world.alienSpawnCount < 10) {
+            return; // Não spawna moeda ainda
+        }
+
+        // Reseta contador
+        world.alienSpawnCount = 0;
+
+        int attempts = 0;
+        glm::vec3 pos;
+        do {
+            pos = glm::vec3(randomFloat(world, -8.0f, 8.0f), 0.7f, randomFloat(world, -38.0f, -32.0f));
+            attempts++;
+        } while (!checkPositionFree(world, pos) && attempts < 10);
+
+        if (attempts < 10) {
+            GameObject obj;
+            obj.position = pos;
+            obj.prevPosition = pos;
+            obj.active = true;
+            obj.type = 1;
+            obj.scale = glm::vec3(0.8f);
+            obj.color = glm::vec3(1.0f, 0.84f, 0.0f);
+            obj.rotation = 0.0f;
+            addObject(world, obj);
+        }
+    }
+}
+
+// Cria partículas de explosão na posição informada. Os sorteios saem em lote, um campo por vez, em blocos
+// de BURST_CHUNK partículas na pilha
+const int BURST_CHUNK = 64;
+
+void createExplosion(GameWorld& world, glm::vec3 position) {
+    if (!world.effects) return;
+    float angle[BURST_CHUNK], speed[BURST_CHUNK], elevation[BURST_CHUNK], lift[BURST_CHUNK];
+    float size[BURST_CHUNK], lifetime[BURST_CHUNK], colorType[BURST_CHUNK];
+
+    int count = scaledCount(40, world.budget.particles);
+    for (int first = 0; first < count; first += BURST_CHUNK) {
+        int n = std::min(BURST_CHUNK, count - first);
+        randomFloats(world, angle, n, 0.0f, 2.0f * M_PI);
+        randomFloats(world, speed, n, 1.5f, 4.0f);
+        randomFloats(world, elevation, n, -0.5f, 1.5f);
+        randomFloats(world, lift, n, 0.5f, 2.5f);
+        randomFloats(world, size, n, 0.08f, 0.18f);
+        randomFloats(world, lifetime, n, 0.8f, 1.5f);
+        randomFloats(world, colorType, n, 0.0f, 1.0f);
+
+        for (int i = 0; i < n; ++i) {
+            Particle p;
+            p.position = position;
+            p.velocity = glm::vec3(
+                cos(angle[i]) * speed[i],
+                elevation[i] + lift[i],
+                sin(angle[i]) * speed[i]
+            );
+            p.size = size[i];
+            p.lifetime = lifetime[i];
+
+            // Cores variadas da explosão
+            if (colorType[i] < 0.4f) {
+                p.color = glm::vec3(1.0f, 0.3f, 0.1f); // Laranja
+            }
+            else if (colorType[i] < 0.7f) {
+                p.color = glm::vec3(1.0f, 0.8f, 0.2f); // Amarelo
+            }
+            else {
+                p.color = glm::vec3(0.9f, 0.1f, 0.1f); // Vermelho
+            }
+
+            if (!world.explosionParticles.emit(p)) return; // Pool cheio: o resto seria descartado
+        }
+    }
+}
+
+// Atualiza toda a lógica do jogo em um passo fixo de deltaTime segundos
+void updateGame(GameWorld& world, float deltaTime) {
+    if (world.gameState != PLAYING) return;
+
+    world.gameTime += deltaTime;
+    world.spawnTimer += deltaTime;
+    world.runAnimationTime += deltaTime * 10.0f;
+
+    world.gameSpeed = GAME_SPEED_START + (world.gameTime * 0.18f);  // Velocidade aumentada + progressão mais rápida
+    world.spawnInterval = glm::max(0.7f, 1.0f - (world.gameTime * 0.012f));
+
+    if (world.spawnTimer >= world.spawnInterval) {
+        world.spawnTimer = 0.0f;
+        if (static_cast<int>(world.obstacles.size()) < scaledCount(MAX_OBJECTS, world.budget.objects)) spawnObject(world, 0);
+        // Moedas agora são controladas pelo contador interno de aliens
+        if (world.collectibles.size() < MAX_COLLECTIBLES) spawnObject(world, 1); // Máximo de 3 moedas na tela
+    }
+
+    // A cena inteira anda em Z; na grade isso é só o scroll
+    float advance = world.gameSpeed * deltaTime;
+    world.grid.scroll += advance;
+    for (auto& obs : world.obstacles) {
+        obs.position.z += advance;
+        if (obs.position.z > 8.0f) obs.active = false;
+    }
+    for (auto& col : world.collectibles) {
+        col.position.z += advance;
+        col.position.y = 0.7f + sin(world.gameTime * 3.0f + col.position.x) * 0.2f;
+        if (col.position.z > 8.0f) col.active = false;
+    }
+
+    // Colisões só com os objetos das células em volta do jogador
+    visitNear(world, world.playerPos, 1.2f, [&](int handle, GameObject& obj) {
+        if (!obj.active) return true;
+
+        if (!(handle & GRID_COLLECTIBLE)) {
+            if (glm::length(obj.position - world.playerPos) < 0.6) {
+                createExplosion(world, obj.position);
+                if (world.budget.invulnerable) {
+                    obj.active = false;
+                    return true;
+                }
+                world.gameState = GAME_OVER;
+                if (world.score > world.highScore) world.highScore = world.score;
+            }
+        }
+        else {
+            GameObject& col = obj;
+            if (glm::length(col.position - world.playerPos) < 1.2f) {
+                col.active = false;
+                world.score += 10;
+
+                int count = world.effects ? scaledCount(20, world.budget.particles) : 0;
+                bool poolFull = false;
+                for (int first = 0; first < count && !poolFull; first += BURST_CHUNK) {
+                    float angle[BURST_CHUNK], speed[BURST_CHUNK], lift[BURST_CHUNK], size[BURST_CHUNK];
+                    int n = std::min(BURST_CHUNK, count - first);
+                    randomFloats(world, angle, n, 0.0f, 2.0f * M_PI);
+                    randomFloats(world, speed, n, 0.5f, 1.5f);
+                    randomFloats(world, lift, n, 1.0f, 3.0f);
+                    randomFloats(world, size, n, 0.05f, 0.1f);
+
+                    for (int i = 0; i < n; ++i) {
+                        Particle p;
+                        p.position = col.position;
+                        p.velocity = glm::vec3(cos(angle[i]) * speed[i], lift[i], sin(angle[i]) * speed[i]);
+                        p.size = size[i];
+                        p.color = glm::vec3(1.0f, 0.84f, 0.0f);
+                        p.lifetime = 1.0f;
+                        if (!world.collectParticles.emit(p)) { // Pool cheio: o resto seria descartado
+                            poolFull = true;
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+        return true;
+    });
+
+    // De trás para frente: o swap-and-pop só traz para o índice atual objetos já verificados
+    for (int i = static_cast<int>(world.obstacles.size()) - 1; i >= 0; --i) {
+        if (!world.obstacles[i].active) removeObject(world, i);
+    }
+    for (int i = static_cast<int>(world.collectibles.size()) - 1; i >= 0; --i) {
+        if (!world.collectibles[i].active) removeObject(world, i | GRID_COLLECTIBLE);
+    }
+
+    // Daqui em diante só partículas, que não afetam a partida
+    if (!world.effects) return;
+
+    world.thrusterParticles.update(deltaTime);
+    world.collectParticles.update(deltaTime);
+    world.speedParticles.update(deltaTime);   // Motion blur e vento
+    world.explosionParticles.update(deltaTime);
+
+    // O brilho do propulsor pulsa com o tempo e a posição de cada partícula
+    ParticlePool& thruster = world.thrusterParticles;
+    for (int i = 0; i < thruster.count; ++i) {
+        thruster.color[i] = glm::mix(glm::vec3(0.2f, 0.5f, 1.0f), glm::vec3(0.8f, 0.9f, 1.0f),
+            sin(world.gameTime * 15.0f + thruster.position[i].x * 10.0f) * 0.5f + 0.5f);
+    }
+
+    // Spawn thruster particles
+    world.particleSpawnTimer += deltaTime;
+    if (world.particleSpawnTimer >= 0.03f) {
+        world.particleSpawnTimer = 0.0f;
+
+        glm::vec3 thrusterPositions[4] = {
+            glm::vec3(-0.3f, -0.5f, 0.0f),
+            glm::vec3(0.3f, -0.5f, 0.0f),
+            glm::vec3(-0.15f, -0.3f, -0.2f),
+            glm::vec3(0.15f, -0.3f, -0.2f)
+        };
+
+        int count = scaledCount(4, world.budget.particles);
+        for (int i = 0; i < count; ++i) {
+            Particle p;
+            p.position = thrusterPositions[i % 4] + glm::vec3(
+                (randomInt(world, 100) - 50) / 500.0f,
+                (randomInt(world, 100) - 50) / 500.0f,
+                (randomInt(world, 100) - 50) / 500.0f
+            );
+            p.velocity = glm::vec3(0.0f, 0.5f, 0.0f); // Sobe devagar
+            p.size = 0.08f + (randomInt(world, 100)) / 1000.0f;
+            p.lifetime = 1.0f;
+            world.thrusterParticles.emit(p);
+        }
+    }
+
+    // Spawn speed particles (motion blur effect)
+    world.speedParticleTimer += deltaTime;
+    if (world.speedParticleTimer >= 0.05f && playerMoving(world)) {
+        world.speedParticleTimer = 0.0f;
+
+        int count = scaledCount(3, world.budget.particles);
+        for (int i = 0; i < count; ++i) {
+            Particle p;
+            p.position = world.playerPos + glm::vec3(
+                randomFloat(world, -0.5f, 0.5f),
+                randomFloat(world, -0.3f, 0.3f),
+                randomFloat(world, -0.5f, 0.2f)
+            );
+            p.velocity = -world.playerVelocity * 5.0f / REFERENCE_FPS;
+            p.size = randomFloat(world, 0.03f, 0.08f);
+            p.lifetime = randomFloat(world, 0.3f, 0.6f);
+            p.color = glm::vec3(0.6f, 0.8f, 1.0f);
+            world.speedParticles.emit(p);
+        }
+    }
+
+    // Spawn wind particles laterais
+    world.windParticleTimer += deltaTime;
+    if (world.windParticleTimer >= 0.08f) {
+        world.windParticleTimer = 0.0f;
+
+        int count = scaledCount(2, world.budget.particles);
+        for (int i = 0; i < count; ++i) {
+            Particle p;
+            float side = (randomInt(world, 2) == 0) ? -10.0f : 10.0f;
+            p.position = glm::vec3(
+                side,
+                randomFloat(world, 0.0f, 2.0f),
+                world.playerPos.z + randomFloat(world, -5.0f, 5.0f)
+            );
+            p.velocity = glm::vec3(-side * 0.3f, 0.0f, world.gameSpeed * 1.5f / REFERENCE_FPS);
+            p.size = randomFloat(world, 0.04f, 0.1f);
+            p.lifetime = randomFloat(world, 1.0f, 2.0f);
+            p.color = glm::vec3(0.9f, 0.95f, 1.0f);
+            world.speedParticles.emit(p);
+        }
+    }
+}
+
+// Zera a partida e entra no estado informado (PLAYING ao começar/recomeçar, MENU ao sair)
+void resetRun(GameWorld& world, GameState state) {
+    world.gameState = state;
+    world.score = 0;
+    world.gameTime = 0.0f;
+    world.gameSpeed = GAME_SPEED_START;
+    world.spawnInterval = 1.0f;
+    world.alienSpawnCount = 0;
+    world.playerPos = glm::vec3(0.0f, 0.5f, 0.0f);
+    world.prevPlayerPos = world.playerPos;
+    world.playerVelocity = glm::vec3(0.0f);
+    world.playerRotation = 0.0f;
+    world.playerTilt = 0.0f;
+    world.runAnimationTime = 0.0f;
+    world.obstacles.clear();
+    world.collectibles.clear();
+    world.obstacles.reserve(obstacleCapacity(world.budget));
+    world.collectibles.reserve(MAX_COLLECTIBLES);
+    world.grid = SpatialGrid();
+    setupParticlePools(world);
+}
+
+// Aplica a entrada de um passo de deltaTime segundos: troca de estado, movimento do jogador e câmera
+void applyInput(GameWorld& world, const SimInput& input, float deltaTime) {
+    if (world.gameState == MENU) {
+        if (input.start) resetRun(world, PLAYING);
+        return;
+    }
+
+    if (world.gameState == GAME_OVER) {
+        if (input.restart) resetRun(world, PLAYING);
+        if (input.menu) resetRun(world, MENU);
+        return;
+    }
+
+	// Movimento do jogador
+    glm::vec3 moveDir(0.0f);
+    if (input.left) moveDir.x -= 1.0f;
+    if (input.right) moveDir.x += 1.0f;
+    if (input.forward) moveDir.z -= 1.0f;
+    if (input.back) moveDir.z += 1.0f;
+
+	// Normaliza direção e aplica velocidade
+    if (glm::length(moveDir) > 0.0f) {
+        world.playerVelocity = glm::normalize(moveDir) * world.playerSpeed;
+        world.playerPos += world.playerVelocity * deltaTime;
+        world.playerPos.x = glm::clamp(world.playerPos.x, -8.0f, 8.0f);
+        world.playerPos.z = glm::clamp(world.playerPos.z, -3.0f, 5.0f);
+
+        float targetRotation = atan2(moveDir.x, moveDir.z) * 180.0f / M_PI;
+        world.playerRotation = glm::mix(world.playerRotation, targetRotation, 1.0f - perFrameFactor(0.8f, deltaTime));
+        world.playerTilt = glm::clamp(moveDir.x * 15.0f, -20.0f, 20.0f);
+    }
+    else {
+        world.playerVelocity *= perFrameFactor(0.8f, deltaTime);
+        world.playerTilt *= perFrameFactor(0.9f, deltaTime);
+    }
+
+    if (input.cameraLeft) world.cameraYaw -= world.cameraRotSpeed * deltaTime;
+    if (input.cameraRight) world.cameraYaw += world.cameraRotSpeed * deltaTime;
+    if (input.cameraUp) world.cameraPitch += world.cameraRotSpeed * deltaTime;
+    if (input.cameraDown) world.cameraPitch -= world.cameraRotSpeed * deltaTime;
+
+    world.cameraPitch = glm::clamp(world.cameraPitch, -89.0f, 89.0f);
+}
+
+void stepSimulation(GameWorld& world, const SimInput& input, float deltaTime) {
+    savePreviousPositions(world);
+    applyInput(world, input, deltaTime);
+    updateGame(world, deltaTime);
+}
+
+// ================== ROTEIRO DE ENTRADA ==================
+bool InputScript::parse(const std::string& text) {
+    segments.clear();
+    period = 0;
+    std::istringstream lines(text);
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(lines, line)) {
+        lineNumber++;
+        size_t begin = line.find_first_not_of(" \t\r");
+        if (begin == std::string::npos || line[begin] == '#') continue;
+
+        std::istringstream fields(line);
+        Segment segment;
+        std::string keys;
+        if (!(fields >> segment.first >> segment.last) || segment.last <= segment.first || segment.first < 0) {
+            std::cerr << "Roteiro invalido na linha " << lineNumber << ": " << line << std::endl;
+            return false;
+        }
+        fields >> keys;
+        for (char c : keys) {
+            switch (c) {
+            case 'W': case 'w': segment.input.forward = true; break;
+            case 'A': case 'a': segment.input.left = true; break;
+            case 'S': case 's': segment.input.back = true; break;
+            case 'D': case 'd': segment.input.right = true; break;
+            case 'E': case 'e': segment.input.start = true; break;
+            case 'R': case 'r': segment.input.restart = true; break;
+            case 'M': case 'm': segment.input.menu = true; break;
+            default:
+                std::cerr << "Tecla desconhecida '" << c << "' no roteiro, linha " << lineNumber << std::endl;
+                return false;
+            }
+        }
+        period = std::max(period, segment.last);
+        segments.push_back(segment);
+    }
+    return true;
+}
+
+bool InputScript::load(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+        std::cerr << "Falha ao abrir roteiro: " << path << std::endl;
+        return false;
+    }
+    std::stringstream text;
+    text << in.rdbuf();
+    return parse(text.str());
+}
+
+// Entrada do passo informado; segmentos sobrepostos somam as teclas
+SimInput InputScript::at(long step) const {
+    SimInput input;
+    if (period == 0) return input;
+    long local = step % period;
+    for (const auto& segment : segments) {
+        if (local < segment.first || local >= segment.last) continue;
+        const SimInput& s = segment.input;
+        input.left |= s.left; input.right |= s.right; input.forward |= s.forward; input.back |= s.back;
+        input.start |= s.start; input.restart |= s.restart; input.menu |= s.menu;
+    }
+    return input;
+}
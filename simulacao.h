@@ -0,0 +1,216 @@
+// simulacao.h: lógica do jogo (jogador, aliens, moedas e partículas) sem janela, OpenGL ou ImGui.
+// O jogo com janela (testeimportacao.cpp) e o executável headless (simulacao_headless.cpp) usam a mesma simulação.
+
+#pragma once
+
+#include <vector>
+#include <string>
+#include <array>
+#include <glm/glm.hpp> // Math para gráficos 3D
+
+#include "aleatorio.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// ================== PASSO DA SIMULAÇÃO ==================
+// Simulação em passo fixo: a lógica roda sempre a SIM_HZ, independente da taxa de quadros, e o render
+// interpola as posições entre os dois últimos passos. As constantes "por frame" do jogo foram ajustadas
+// a 60 FPS; REFERENCE_FPS converte essas taxas para unidades por segundo.
+const float SIM_HZ = 120.0f;
+const float SIM_DT = 1.0f / SIM_HZ;
+const int MAX_SIM_STEPS = 8;       // Evita a espiral de passos acumulados em frames muito lentos
+const float REFERENCE_FPS = 60.0f;
+
+const float GAME_SPEED_START = 7.2f;  // Unidades por segundo
+const int MAX_OBJECTS = 30;
+const int MAX_COLLECTIBLES = 3;
+
+// Estados do jogo
+enum GameState { MENU, PLAYING, GAME_OVER };
+
+// Estrutura para objetos do jogo (aliens, moedas, etc)
+struct GameObject {
+    glm::vec3 position;
+    glm::vec3 prevPosition; // Posição no passo anterior, para interpolar o render
+    glm::vec3 scale;
+    glm::vec3 color;
+    float rotation;
+    bool active;
+    int type;
+    int gridBucket = -1; // Balde da grade espacial onde o objeto está (-1 = fora da grade)
+    int gridNext = -1;   // Próximo objeto do mesmo balde
+};
+
+// ================== GRADE ESPACIAL ==================
+// Hash espacial no plano XZ para as consultas de vizinhança (spawn livre, colisão com o jogador). Todos os
+// objetos andam em Z com a mesma velocidade, então a grade usa coordenadas que rolam junto com eles
+// (z - scroll): um objeto nunca troca de célula, e mover a cena inteira é só somar em scroll.
+// Cada balde é uma lista encadeada intrusiva (GameObject::gridNext) de handles: o índice em obstacles, ou
+// o índice em collectibles com GRID_COLLECTIBLE. Nada é alocado depois do primeiro spawn.
+const float GRID_CELL_SIZE = 2.5f;   // Igual à maior distância consultada
+const int GRID_BUCKETS = 256;        // Potência de 2
+const int GRID_COLLECTIBLE = 1 << 30;
+
+struct SpatialGrid {
+    std::array<int, GRID_BUCKETS> heads;
+    double scroll = 0.0; // Deslocamento Z acumulado; double para não acumular erro em partidas longas
+
+    SpatialGrid() { heads.fill(-1); }
+};
+
+// ================== PARTÍCULAS ==================
+// Uma partícula no momento da emissão; depois de emitida ela vive campo a campo no ParticlePool.
+// Também é o registro de spawn enviado ao backend de partículas na GPU (11 floats, sem padding)
+struct Particle {
+    glm::vec3 position = glm::vec3(0.0f);
+    glm::vec3 velocity = glm::vec3(0.0f);
+    glm::vec3 color = glm::vec3(1.0f);
+    float size = 0.0f;
+    float lifetime = 0.0f;
+};
+
+// Pool SoA de um sistema de partículas: cada campo num vetor próprio de capacidade fixa, com as partículas
+// vivas em [0, count). A que morre recebe a última no lugar (swap-and-pop) e nada é alocado depois de
+// allocate(). O render envia position/color/size/lifetime direto para os buffers de instância.
+struct ParticlePool {
+    std::vector<glm::vec3> position; // No propulsor, deslocamento no espaço do jogador
+    std::vector<glm::vec3> velocity;
+    std::vector<glm::vec3> color;
+    std::vector<float> size;
+    std::vector<float> lifetime;
+    int count = 0;
+
+    // Evolução do sistema: vida perdida por segundo, gravidade e encolhimento por frame a 60 FPS
+    float decay = 1.0f;
+    float gravity = 0.0f;
+    float shrink = 1.0f;
+
+    // Backend externo (partículas na GPU): emit só enfileira em spawned, que o render consome, e o pool fica
+    // vazio. epoch muda a cada allocate(), para o backend descartar as partículas da partida anterior
+    bool external = false;
+    std::vector<Particle> spawned;
+    unsigned int epoch = 0;
+
+    int capacity() const { return static_cast<int>(lifetime.size()); }
+    void allocate(int newCapacity);
+    void clear() { count = 0; }
+    bool emit(const Particle& p); // false com o pool cheio (a partícula é descartada)
+    void update(float deltaTime);
+};
+
+const int PARTICLE_POOL_CAPACITY = 512; // Por sistema; o SimBudget multiplica
+
+// Entrada de um passo da simulação, já traduzida do teclado (jogo) ou de um roteiro (headless)
+struct SimInput {
+    bool left = false, right = false, forward = false, back = false;
+    bool cameraLeft = false, cameraRight = false, cameraUp = false, cameraDown = false;
+    bool start = false;   // Começa a partida no menu
+    bool restart = false; // Recomeça a partida no game over
+    bool menu = false;    // Volta ao menu no game over
+};
+
+// Multiplicadores de carga do modo de estresse (1 = jogo normal)
+struct SimBudget {
+    float objects = 1.0f;      // Limite de aliens, aliens por onda e profundidade da faixa de spawn
+    float particles = 1.0f;    // Partículas emitidas por propulsor, velocidade, vento, coleta e explosão
+    bool invulnerable = false; // Alien que acerta o jogador só explode, sem game over
+};
+
+// ================== ESTADO DA SIMULAÇÃO ==================
+// Uma partida completa como tipo valor: vários mundos independentes podem ser copiados, guardados e
+// simulados em paralelo (ver simulacao_lote.h). O jogo com janela usa um único mundo.
+struct GameWorld {
+    GameState gameState = MENU;
+
+    // Variáveis do jogador
+    glm::vec3 playerPos = glm::vec3(0.0f, 0.5f, 0.0f);
+    glm::vec3 prevPlayerPos = glm::vec3(0.0f, 0.5f, 0.0f);
+    glm::vec3 playerVelocity = glm::vec3(0.0f);  // Unidades por segundo
+    float playerSpeed = 5.4f;                    // Unidades por segundo
+    float playerRotation = 0.0f;
+    float playerTilt = 0.0f;                     // Inclinação do jogador ao virar
+    float runAnimationTime = 0.0f;               // Tempo para animação de corrida
+    float gameSpeed = GAME_SPEED_START;          // Velocidade do jogo
+    int score = 0;
+    int highScore = 0;
+    float gameTime = 0.0f;
+
+    // Sistemas de partículas (thruster, coleta, velocidade, explosão)
+    ParticlePool thrusterParticles;
+    ParticlePool collectParticles;
+    ParticlePool speedParticles;
+    ParticlePool explosionParticles;
+    float particleSpawnTimer = 0.0f;
+    float speedParticleTimer = 0.0f;
+    float windParticleTimer = 0.0f;
+    bool effects = true; // Partículas são só visuais; mundos de treino podem desligá-las
+    SimBudget budget;
+
+    // Ângulo e velocidade de rotação da câmera (controlados pelas setas)
+    float cameraYaw = -90.0f;
+    float cameraPitch = -20.0f;
+    float cameraRotSpeed = 48.0f;                // Graus por segundo
+
+    // Vetores de objetos do jogo
+    std::vector<GameObject> obstacles;
+    std::vector<GameObject> collectibles;
+    SpatialGrid grid;                            // Índice de obstacles e collectibles por célula XZ
+    float spawnTimer = 0.0f;
+    float spawnInterval = 1.0f;
+    int alienSpawnCount = 0;                     // Contador para spawn de moedas raras
+
+    // Gerador próprio de cada mundo: mundos com a mesma semente e a mesma entrada evoluem igual
+    Rng rng;
+};
+
+// ================== FUNÇÕES DA SIMULAÇÃO ==================
+float randomFloat(GameWorld& world, float min, float max);
+int randomInt(GameWorld& world, int n);
+void randomFloats(GameWorld& world, float* out, int count, float min, float max);
+int scaledCount(int base, float factor);
+int particlePoolCapacity(const SimBudget& budget);
+int obstacleCapacity(const SimBudget& budget);
+float perFrameFactor(float factor, float dt);
+bool playerMoving(const GameWorld& world);
+void savePreviousPositions(GameWorld& world);
+glm::vec3 interpolatedPosition(const GameObject& obj, float alpha);
+
+// Adiciona/remove objetos mantendo a grade; a remoção troca o objeto com o último do vetor (swap-and-pop)
+void addObject(GameWorld& world, const GameObject& obj);
+void removeObject(GameWorld& world, int handle);
+
+bool checkPositionFree(const GameWorld& world, glm::vec3 pos, float minDistance = 2.5f);
+void spawnObject(GameWorld& world, int type);
+void createExplosion(GameWorld& world, glm::vec3 position);
+
+// Liga/desliga o backend externo de partículas em todos os sistemas (as partículas vivas são descartadas)
+void setExternalParticles(GameWorld& world, bool external);
+
+// Zera a partida (jogador, objetos, partículas) e entra no estado informado. Também reserva toda a memória
+// da partida conforme o SimBudget: depois da primeira chamada, os passos não alocam mais nada
+void resetRun(GameWorld& world, GameState state);
+void applyInput(GameWorld& world, const SimInput& input, float deltaTime);
+void updateGame(GameWorld& world, float deltaTime);
+
+// Um passo completo: guarda as posições anteriores, aplica a entrada e atualiza o jogo
+void stepSimulation(GameWorld& world, const SimInput& input, float deltaTime);
+
+// ================== ROTEIRO DE ENTRADA ==================
+// Entrada para rodar sem teclado. Cada linha do roteiro tem "<passo inicial> <passo final> <teclas>", com as
+// teclas W/A/S/D (movimento), E (iniciar), R (reiniciar) e M (menu); linhas vazias e começando com # são
+// ignoradas. O intervalo inclui o passo inicial e exclui o final, e o roteiro se repete com período igual
+// ao maior passo final.
+struct InputScript {
+    struct Segment {
+        long first, last;
+        SimInput input;
+    };
+    std::vector<Segment> segments;
+    long period = 0;
+
+    bool parse(const std::string& text);
+    bool load(const std::string& path);
+    SimInput at(long step) const;
+};
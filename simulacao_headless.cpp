@@ -0,0 +1,120 @@
+// simulacao_headless.cpp: roda partidas completas da simulação sem janela, para balanceamento e testes de regressão.
+//
+// Uso: simulacao_headless [execucoes] [segundos] [semente] [roteiro]
+//   execucoes: número de partidas (padrão 1000)
+//   segundos:  duração máxima de cada partida em tempo de jogo (padrão 120)
+//   semente:   semente da partida 0; a partida i usa semente + i (padrão 1)
+//   roteiro:   arquivo de roteiro de entrada (formato em simulacao.h); sem ele, o jogador faz zigue-zague
+//
+// Uso: simulacao_headless lote [mundos] [passos] [threads] [semente]
+//   Mede a API em lote (simulacao_lote.h): mundos (padrão 4096) avançam juntos por passos (padrão 2000)
+//   chamadas de step(), com o zigue-zague defasado por mundo; threads = 0 usa todos os núcleos.
+#include "simulacao.h"
+#include "simulacao_lote.h"
+
+#include <iostream>
+#include <cstdlib>
+#include <chrono>
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+
+// Zigue-zague entre as bordas da pista com avanços curtos (passos de 1/120 s)
+const char* DEFAULT_SCRIPT =
+    "0 180 A\n"
+    "180 200 W\n"
+    "200 560 D\n"
+    "560 580 S\n"
+    "580 760 A\n";
+
+// Bits de ação equivalentes a uma entrada do roteiro
+uint8_t actionFromInput(const SimInput& input) {
+    return (input.left ? ACTION_LEFT : 0) | (input.right ? ACTION_RIGHT : 0) |
+           (input.forward ? ACTION_FORWARD : 0) | (input.back ? ACTION_BACK : 0);
+}
+
+int runBatch(int argc, char** argv) {
+    int worldCount = argc > 2 ? std::atoi(argv[2]) : 4096;
+    long steps = argc > 3 ? std::atol(argv[3]) : 2000;
+    int threads = argc > 4 ? std::atoi(argv[4]) : 0;
+    uint64_t seed = argc > 5 ? std::strtoull(argv[5], nullptr, 10) : 1u;
+    if (worldCount <= 0 || steps <= 0 || threads < 0) {
+        std::cerr << "Uso: " << argv[0] << " lote [mundos] [passos] [threads] [semente]\n";
+        return 1;
+    }
+
+    InputScript script;
+    if (!script.parse(DEFAULT_SCRIPT)) return 1;
+
+    WorldBatch batch(worldCount, seed, threads);
+    std::vector<uint8_t> actions(worldCount);
+    double rewardSum = 0.0;
+    long episodes = 0;
+
+    auto begin = std::chrono::steady_clock::now();
+    for (long step = 0; step < steps; ++step) {
+        for (int i = 0; i < worldCount; ++i) actions[i] = actionFromInput(script.at(step + i * 37L));
+        batch.step(actions.data());
+        for (int i = 0; i < worldCount; ++i) {
+            rewardSum += batch.rewards[i];
+            episodes += batch.dones[i];
+        }
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    double worldSteps = static_cast<double>(worldCount) * steps;
+
+    std::cout << "Lote: " << worldCount << " mundos, " << steps << " passos, " << batch.threadCount() << " threads\n"
+              << "Partidas terminadas: " << episodes << ", recompensa total: " << rewardSum << "\n"
+              << "Tempo: " << elapsed << " s (" << worldSteps / elapsed << " passos/s)" << std::endl;
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1 && std::strcmp(argv[1], "lote") == 0) return runBatch(argc, argv);
+
+    int runs = argc > 1 ? std::atoi(argv[1]) : 1000;
+    float maxSeconds = argc > 2 ? static_cast<float>(std::atof(argv[2])) : 120.0f;
+    uint64_t seed = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 1u;
+    if (runs <= 0 || maxSeconds <= 0.0f) {
+        std::cerr << "Uso: " << argv[0] << " [execucoes] [segundos] [semente] [roteiro]\n";
+        return 1;
+    }
+
+    InputScript script;
+    bool scriptOk = argc > 4 ? script.load(argv[4]) : script.parse(DEFAULT_SCRIPT);
+    if (!scriptOk) return 1;
+
+    long maxSteps = static_cast<long>(maxSeconds * SIM_HZ);
+    long totalSteps = 0;
+    long long scoreSum = 0;
+    double survivalSum = 0.0;
+    int bestScore = 0, survivedAll = 0;
+
+    auto begin = std::chrono::steady_clock::now();
+    for (int run = 0; run < runs; ++run) {
+        GameWorld world;
+        world.effects = false;
+        world.rng.seed(seed + run);
+        resetRun(world, PLAYING);
+
+        long step = 0;
+        while (world.gameState == PLAYING && step < maxSteps) {
+            stepSimulation(world, script.at(step), SIM_DT);
+            step++;
+        }
+
+        totalSteps += step;
+        scoreSum += world.score;
+        survivalSum += world.gameTime;
+        bestScore = std::max(bestScore, world.score);
+        if (world.gameState == PLAYING) survivedAll++;
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    std::cout << "Partidas: " << runs << " (limite " << maxSeconds << " s, semente " << seed << ")\n"
+              << "Pontuacao media: " << static_cast<double>(scoreSum) / runs << ", melhor: " << bestScore << "\n"
+              << "Sobrevivencia media: " << survivalSum / runs << " s, chegaram ao limite: " << survivedAll << "\n"
+              << "Tempo: " << elapsed << " s (" << runs / elapsed << " partidas/s, "
+              << totalSteps / elapsed << " passos/s)" << std::endl;
+    return 0;
+}
@@ -0,0 +1,162 @@
+// simulacao_lote.cpp: passo em lote de vários mundos, dividido entre threads
+#include "simulacao_lote.h"
+
+#include <algorithm>
+#include <utility>
+
+WorldBatch::WorldBatch(int worldCount, uint64_t seed, int threadCount)
+    : worlds(static_cast<size_t>(std::max(worldCount, 1))) {
+    int count = size();
+    observations.assign(static_cast<size_t>(OBS_FIELDS) * count, 0.0f);
+    rewards.assign(count, 0.0f);
+    dones.assign(count, 0);
+
+    // Partículas não mudam a partida; desligadas, cada passo custa só a lógica
+    for (int i = 0; i < count; ++i) {
+        worlds[i].effects = false;
+        worlds[i].rng.seed(seed + static_cast<uint64_t>(i));
+    }
+
+    if (threadCount <= 0) threadCount = static_cast<int>(std::thread::hardware_concurrency());
+    threadCount = std::max(1, std::min(threadCount, count));
+    for (int slot = 1; slot < threadCount; ++slot) {
+        workers.emplace_back(&WorldBatch::workerLoop, this, slot);
+    }
+
+    reset();
+}
+
+WorldBatch::~WorldBatch() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers) worker.join();
+}
+
+void WorldBatch::reset() {
+    for (int i = 0; i < size(); ++i) {
+        resetRun(worlds[i], PLAYING);
+        rewards[i] = 0.0f;
+        dones[i] = 0;
+        writeObservation(i);
+    }
+}
+
+void WorldBatch::step(const uint8_t* actions, int substeps) {
+    currentActions = actions;
+    currentSubsteps = std::max(substeps, 1);
+
+    if (workers.empty()) {
+        stepRange(0, size());
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending = static_cast<int>(workers.size());
+        generation++;
+    }
+    wake.notify_all();
+
+    // A thread chamadora fica com a faixa 0
+    int chunk = (size() + threadCount() - 1) / threadCount();
+    stepRange(0, std::min(chunk, size()));
+
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [this] { return pending == 0; });
+}
+
+void WorldBatch::workerLoop(int slot) {
+    unsigned long seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+        }
+
+        int chunk = (size() + threadCount() - 1) / threadCount();
+        int first = std::min(slot * chunk, size());
+        stepRange(first, std::min(first + chunk, size()));
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--pending == 0) finished.notify_one();
+    }
+}
+
+void WorldBatch::stepRange(int first, int last) {
+    for (int i = first; i < last; ++i) {
+        GameWorld& world = worlds[i];
+        uint8_t action = currentActions[i];
+
+        SimInput input;
+        input.left = (action & ACTION_LEFT) != 0;
+        input.right = (action & ACTION_RIGHT) != 0;
+        input.forward = (action & ACTION_FORWARD) != 0;
+        input.back = (action & ACTION_BACK) != 0;
+
+        int startScore = world.score;
+        uint8_t done = 0;
+        for (int s = 0; s < currentSubsteps; ++s) {
+            stepSimulation(world, input, SIM_DT);
+            if (world.gameState != PLAYING) {
+                done = 1;
+                break;
+            }
+        }
+
+        rewards[i] = static_cast<float>(world.score - startScore);
+        dones[i] = done;
+        if (done) resetRun(world, PLAYING);
+        writeObservation(i);
+    }
+}
+
+void WorldBatch::writeObservation(int index) {
+    const GameWorld& world = worlds[index];
+    const size_t stride = worlds.size();
+    float* out = observations.data() + index;
+    int field = 0;
+    auto put = [&](float value) { out[stride * field++] = value; };
+
+    put(world.playerPos.x);
+    put(world.playerPos.z);
+    put(world.playerVelocity.x);
+    put(world.playerVelocity.z);
+    put(world.gameSpeed);
+
+    // Distância² de cada objeto ao jogador no plano XZ; o buffer é por thread e só cresce
+    thread_local std::vector<std::pair<float, int>> nearest;
+    auto fillNearest = [&](const std::vector<GameObject>& objects, int wanted) {
+        int count = static_cast<int>(objects.size());
+        nearest.resize(std::max(nearest.size(), objects.size()));
+        for (int i = 0; i < count; ++i) {
+            float dx = objects[i].position.x - world.playerPos.x;
+            float dz = objects[i].position.z - world.playerPos.z;
+            nearest[i] = { dx * dx + dz * dz, i };
+        }
+        int kept = std::min(count, wanted);
+        std::partial_sort(nearest.begin(), nearest.begin() + kept, nearest.begin() + count);
+        return kept;
+    };
+
+    int kept = fillNearest(world.obstacles, OBS_NEAREST_OBSTACLES);
+    for (int k = 0; k < OBS_NEAREST_OBSTACLES; ++k) {
+        glm::vec3 d(0.0f, 0.0f, OBS_EMPTY_DZ);
+        if (k < kept) d = world.obstacles[nearest[k].second].position - world.playerPos;
+        put(d.x);
+        put(d.y);
+        put(d.z);
+    }
+
+    kept = fillNearest(world.collectibles, OBS_NEAREST_COINS);
+    for (int k = 0; k < OBS_NEAREST_COINS; ++k) {
+        glm::vec3 d(0.0f, 0.0f, OBS_EMPTY_DZ);
+        if (k < kept) d = world.collectibles[nearest[k].second].position - world.playerPos;
+        put(d.x);
+        put(d.z);
+    }
+}
@@ -0,0 +1,68 @@
+// simulacao_lote.h: avança N mundos independentes em lockstep, para treinar e avaliar bots de piloto automático.
+//
+// Cada chamada de step() recebe uma ação por mundo e devolve, em vetores contíguos, a observação, a recompensa
+// (variação da pontuação) e o fim de partida de cada mundo. As saídas ficam em SoA entre os mundos: o valor de
+// um campo para todos os mundos é contíguo, ou seja, observations[campo * size() + mundo].
+
+#pragma once
+
+#include "simulacao.h"
+
+#include <cstdint>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+// Bits da ação de um mundo
+const uint8_t ACTION_LEFT = 1 << 0;
+const uint8_t ACTION_RIGHT = 1 << 1;
+const uint8_t ACTION_FORWARD = 1 << 2;
+const uint8_t ACTION_BACK = 1 << 3;
+
+// Campos da observação: jogador (x, z, velocidade x, velocidade z, velocidade do jogo), os aliens mais
+// próximos (dx, dy, dz relativos ao jogador) e as moedas mais próximas (dx, dz). Vagas sem objeto recebem
+// um objeto fictício parado no ponto de spawn (dz = OBS_EMPTY_DZ).
+const int OBS_NEAREST_OBSTACLES = 8;
+const int OBS_NEAREST_COINS = 2;
+const int OBS_PLAYER_FIELDS = 5;
+const int OBS_FIELDS = OBS_PLAYER_FIELDS + OBS_NEAREST_OBSTACLES * 3 + OBS_NEAREST_COINS * 2;
+const float OBS_EMPTY_DZ = -40.0f;
+
+struct WorldBatch {
+    // O mundo i usa a semente seed + i. threadCount = 0 usa todos os núcleos; a thread que chama step() também trabalha
+    WorldBatch(int worldCount, uint64_t seed, int threadCount = 0);
+    ~WorldBatch();
+    WorldBatch(const WorldBatch&) = delete;
+    WorldBatch& operator=(const WorldBatch&) = delete;
+
+    // Recomeça todas as partidas e recalcula as observações
+    void reset();
+
+    // Aplica actions[mundo] (bits ACTION_*) por substeps passos de SIM_DT. Um mundo que perde é recomeçado
+    // na hora: dones[mundo] = 1 e a observação já é a da partida nova.
+    void step(const uint8_t* actions, int substeps = 1);
+
+    int size() const { return static_cast<int>(worlds.size()); }
+    int threadCount() const { return static_cast<int>(workers.size()) + 1; }
+
+    std::vector<GameWorld> worlds;
+    std::vector<float> observations; // OBS_FIELDS * size()
+    std::vector<float> rewards;      // size()
+    std::vector<uint8_t> dones;      // size()
+
+private:
+    void stepRange(int first, int last);
+    void writeObservation(int index);
+    void workerLoop(int slot);
+
+    // Pool fixo: cada thread fica com uma faixa contígua de mundos, sempre a mesma entre passos
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake, finished;
+    unsigned long generation = 0;
+    int pending = 0;
+    bool stopping = false;
+    const uint8_t* currentActions = nullptr;
+    int currentSubsteps = 1;
+};
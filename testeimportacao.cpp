@@ -5,7 +5,32 @@
 #include <ctime>
 #include <string>
 #include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <filesystem>
+#include <unordered_map>
+#include <algorithm>
+#include <climits>
+#include <cfloat>
+#include <cstddef>
+#include <initializer_list>
+#include <atomic>
+#include <new>
+#include <cassert>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h> // Mapeamento de arquivos em memória (cache de malhas)
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
+#include "simulacao.h" // Lógica do jogo (sem GL)
 #include "glad/glad.h" // Loader do OpenGL
 #include <GLFW/glfw3.h> // Janela e input
 #include <glm/glm.hpp> // Math para gráficos 3D
@@ -20,8 +45,21 @@
 #define STB_IMAGE_IMPLEMENTATION
 #include "external/stb_image.h" // Carregamento de imagens
 
-#ifndef M_PI
-#define M_PI 3.14159265358979323846
+// ================== CONTADOR DE ALOCAÇÕES (DEBUG) ==================
+// Em debug, todo new/delete do jogo passa por aqui. Depois do aquecimento o loop principal não pode alocar:
+// objetos, partículas e estatísticas são reservados na inicialização, e uma alocação vira travada em
+// hardware fraco. (ImGui, GLFW e o driver usam malloc e não entram na conta.)
+#ifndef NDEBUG
+std::atomic<unsigned long> heapAllocations{ 0 };
+const int ALLOCATION_WARMUP_FRAMES = 120;
+
+void* operator new(std::size_t size) {
+    heapAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
 #endif
 
 // ================== CONFIGURAÇÕES DE ARQUIVOS E CONSTANTES ==================
@@ -43,114 +81,100 @@ const std::string GROUND_TEXTURE = BASE_PATH + "textures/concretewall.jpg";
 const float IRONMAN_SCALE = 0.005f;
 const float ALIEN_SCALE = 0.03f;
 const float BITCOIN_SCALE = 0.025f;
-const unsigned int SHADOW_SIZE = 2500;
 const bool FULLSCREEN = false;
 const int WINDOW_WIDTH = 1400;
 const int WINDOW_HEIGHT = 900;
 const float CAMERA_DISTANCE = 10.0f;
 const float CAMERA_HEIGHT = 7.0f;
 const float FOV_DEGREES = 60.0f;
+const float CAMERA_NEAR = 0.1f;
+const float CAMERA_FAR = 100.0f;
 const int GROUND_SIZE = 120;
 const float GROUND_QUAD_SIZE = 1.5f;
+const int GROUND_CHUNKS = 6; // chunks por lado do chão
 
+const int SWAP_INTERVAL = 1;       // 1 = vsync, 0 = render sem limite
 
-// Estados do jogo
-enum GameState { MENU, PLAYING, GAME_OVER };
+// Sombras em cascata: o frustum da câmera até SHADOW_DISTANCE é fatiado e cada fatia ganha um mapa de
+// profundidade próprio, numa camada de uma textura array. Quantidade e resolução mudam com --shadows
+const int MAX_SHADOW_CASCADES = 4;        // Tamanho dos arrays no bloco FrameData
+const int SHADOW_CASCADES = 3;
+const int SHADOW_CASCADE_SIZE = 1024;     // 3 x 1024² texels contra os 2500² do mapa único de antes
+const float SHADOW_DISTANCE = 50.0f;      // Além disso não há sombra (a neblina já cobre)
+const float SHADOW_SPLIT_LAMBDA = 0.5f;   // 0 = fatias uniformes, 1 = logarítmicas
+const float SHADOW_CASTER_MARGIN = 30.0f; // Estende cada caixa em direção ao sol, para pegar quem projeta sombra de fora da fatia
+const float SHADOW_CACHE_SLACK = 0.2f;    // Folga da caixa (fração do raio da fatia) para o cache das sombras estáticas durar
+
+// Filtro das sombras: cada amostra é uma comparação com PCF bilinear feita pelo hardware (sampler2DArrayShadow).
+// Com mais de uma amostra, elas seguem um disco de Poisson girado por fragmento
+const int MAX_SHADOW_PCF_TAPS = 16;       // Tamanho do disco no shader
+const int SHADOW_PCF_TAPS = 4;
+const float SHADOW_PCF_RADIUS = 1.5f;     // Raio do disco em texels
 
-// Estrutura para objetos do jogo (aliens, moedas, etc)
-struct GameObject {
-    glm::vec3 position;
-    glm::vec3 scale;
-    glm::vec3 color;
-    float rotation;
-    bool active;
-    int type;
-};
 
 // ================== VARIÁVEIS GLOBAIS ===============
 int currentWidth = WINDOW_WIDTH;
 int currentHeight = WINDOW_HEIGHT;
-GameState gameState = MENU;
-
-// Estruturas para partículas de efeitos
-struct ThrusterParticle {
-    glm::vec3 offset;
-    float size;
-    float intensity;
-    float lifetime;
-};
 
-// Partículas de coleta
-struct CollectParticle {
-    glm::vec3 position;
-    glm::vec3 velocity;
-    float size;
-    float lifetime;
+// Partida em andamento (toda a lógica fica em simulacao.cpp)
+GameWorld world;
+
+// Distância e altura da câmera em relação ao jogador
+float cameraDistance = CAMERA_DISTANCE;
+float cameraHeight = CAMERA_HEIGHT;
+
+// Volume envolvente em espaço do modelo: AABB e esfera centrada na AABB
+struct MeshBounds {
+    glm::vec3 min = glm::vec3(0.0f), max = glm::vec3(0.0f);
+    glm::vec3 center = glm::vec3(0.0f);
+    float radius = 0.0f;
 };
 
-// Partículas de velocidade
-struct SpeedParticle {
-    glm::vec3 position;
-    glm::vec3 velocity;
-    float size;
-    float lifetime;
-    glm::vec3 color;
+// Malha na GPU: VAO com VBO de vértices intercalados e EBO de índices
+struct Mesh {
+    GLuint vao = 0, vbo = 0, ebo = 0;
+    GLsizei indexCount = 0;
+    MeshBounds bounds;
 };
 
-// Partículas de explosão
-struct ExplosionParticle {
-    glm::vec3 position;
-    glm::vec3 velocity;
-    float size;
-    float lifetime;
-    glm::vec3 color;
+// Malhas usadas para renderização no programa shader
+Mesh playerMesh, cubeMesh, sphereMesh, groundMesh, quadMesh;
+Mesh alienMesh, bitcoinMesh;
+Mesh cloudMesh[5], treeMesh;
+
+// Malha desenhada por instâncias: VAO próprio que reaproveita o VBO/EBO da malha e lê a matriz model
+// de um buffer de instâncias (atributos 3-6, divisor 1)
+struct InstancedMesh {
+    GLuint vao = 0, instanceVBO = 0;
+    GLsizei instanceCount = 0, capacity = 0;
 };
+InstancedMesh treeShadowInstances, treeCameraInstances;
+std::vector<glm::mat4> treeModels, visibleTreeModels;
 
-// Variáveis do jogador
-glm::vec3 playerPos = glm::vec3(0.0f, 0.5f, 0.0f);
-glm::vec3 playerVelocity = glm::vec3(0.0f);
-float playerSpeed = 0.09f;  // Velocidade do jogador
-float playerRotation = 0.0f;
-float playerTilt = 0.0f; // Inclinação do jogador ao virar
-float runAnimationTime = 0.0f; // Tempo para animação de corrida
-float gameSpeed = 0.12f;  // Velocidade do jogo
-int score = 0;
-int highScore = 0;
-float gameTime = 0.0f;
-
-// Vetores de partículas (thruster, coleta, velocidade, explosão)
-std::vector<ThrusterParticle> thrusterParticles;
-std::vector<CollectParticle> collectParticles;
-std::vector<SpeedParticle> speedParticles;
-std::vector<ExplosionParticle> explosionParticles;
-
-// Configs da câmera (distância, altura, ângulo, velocidade de rotação)
-float cameraDistance = CAMERA_DISTANCE;
-float cameraHeight = CAMERA_HEIGHT;
-float cameraYaw = -90.0f;
-float cameraPitch = -20.0f;
-float cameraRotSpeed = 0.8f;
-
-// Vetores de objetos do jogo
-std::vector<GameObject> obstacles;
-std::vector<GameObject> collectibles;
-const int MAX_OBJECTS = 30;
-float spawnTimer = 0.0f;
-float spawnInterval = 1.0f;
-
-// IDs de buffers e contadores de vértices para renderização no programa shader
-GLuint playerVAO, playerVBO, cubeVAO, cubeVBO, sphereVAO, sphereVBO, groundVAO, groundVBO;
-GLuint alienVAO, alienVBO, bitcoinVAO, bitcoinVBO;
-GLuint cloudVAO[5], cloudVBO[5], treeVAO, treeVBO;
-int playerVertexCount = 0, cubeVertexCount = 0, sphereVertexCount = 0;
-int alienVertexCount = 0, bitcoinVertexCount = 0;
-int cloudVertexCount[5] = { 0 }, treeVertexCount = 0;
+// Partículas: um billboard (quad virado para a câmera) por partícula, um desenho instanciado por sistema.
+// Cada campo do ParticlePool tem o próprio buffer de instância e é enviado do jeito que está na simulação
+enum ParticleBuffer { PARTICLE_POSITION, PARTICLE_COLOR, PARTICLE_SIZE, PARTICLE_LIFETIME, PARTICLE_BUFFER_COUNT };
+GLuint particleVAO, particleInstanceVBOs[PARTICLE_BUFFER_COUNT];
 
 bool alienModelLoaded = false;
 bool bitcoinModelLoaded = false;
 
-// Shadow mapping e textura do chão
+// Shadow mapping (uma camada de depthMap por cascata) e textura do chão
 GLuint depthMapFBO, depthMap, groundTexture;
+int shadowCascades = SHADOW_CASCADES;
+int shadowCascadeSize = SHADOW_CASCADE_SIZE;
+int shadowPcfTaps = SHADOW_PCF_TAPS;
+
+// Cache das sombras estáticas (árvores): uma camada por cascata com só as árvores, refeita quando a matriz da
+// cascata muda (sol mexido nos sliders ou caixa deslocada pela câmera). A cada frame a camada é copiada para
+// depthMap e só jogador, aliens e moedas são desenhados por cima
+struct StaticShadowCache {
+    GLuint fbo = 0, depthMap = 0;
+    glm::mat4 lightSpace[MAX_SHADOW_CASCADES];
+    bool valid[MAX_SHADOW_CASCADES] = {};
+    int rebuilds = 0; // Camadas refeitas no frame, mostradas na janela "Desempenho"
+};
+StaticShadowCache staticShadows;
 glm::vec3 sunPos(5.0f, 40.0f, 10.0f);
 float sunScale = 2.0f;
 
@@ -181,18 +205,16 @@ float cloudScale[NUM_CLOUDS] = { 0.20f, 0.21f, 0.21f, 0.22f, 0.22f, 0.20f, 0.18f
 // Arvores 
 const int NUM_TREE_ROWS = 3;
 const int TREES_PER_ROW = 12;
-const int NUM_TREES = NUM_TREE_ROWS * TREES_PER_ROW * 2;
+int treeRows = NUM_TREE_ROWS; // Fileiras por lado (o modo de estresse multiplica)
 std::vector<glm::vec3> treePositions;
 std::vector<float> treeScales;
 std::vector<float> treeRotations;
 
-// Contador para spawn de moedas raras
-int alienSpawnCount = 0;
-
 // ================== FUNÇÕES AUXILIARES ==================
-// Gera um float aleatório entre min e max
-float randomFloat(float min, float max) {
-    return min + static_cast<float>(rand()) / (static_cast<float>(RAND_MAX / (max - min)));
+// Sorteios do cenário (árvores) com gerador próprio, para não consumir a sequência da partida
+Rng sceneryRng;
+float sceneryRandom(float min, float max) {
+    return min + sceneryRng.nextFloat() * (max - min);
 }
 
 // Inicializa posições, escalas e rotações das árvores
@@ -202,23 +224,23 @@ void initializeTrees() {
     treeRotations.clear();
 
     // Lado esquerdo
-    for (int row = 0; row < NUM_TREE_ROWS; row++) {
+    for (int row = 0; row < treeRows; row++) {
         float xPos = -12.0f - row * 3.0f;
         for (int i = 0; i < TREES_PER_ROW; i++) {
             float zPos = -40.0f + i * 7.0f;
             treePositions.push_back(glm::vec3(xPos, 0.0f, zPos));
-            treeScales.push_back(randomFloat(0.007f, 0.012f));
-            treeRotations.push_back(randomFloat(0.0f, 360.0f));
+            treeScales.push_back(sceneryRandom(0.007f, 0.012f));
+            treeRotations.push_back(sceneryRandom(0.0f, 360.0f));
         }
     }
     // Lado direito
-    for (int row = 0; row < NUM_TREE_ROWS; row++) {
+    for (int row = 0; row < treeRows; row++) {
         float xPos = 12.0f + row * 3.0f;
         for (int i = 0; i < TREES_PER_ROW; i++) {
             float zPos = -40.0f + i * 7.0f;
             treePositions.push_back(glm::vec3(xPos, 0.0f, zPos));
-            treeScales.push_back(randomFloat(0.007f, 0.012f));
-            treeRotations.push_back(randomFloat(0.0f, 360.0f));
+            treeScales.push_back(sceneryRandom(0.007f, 0.012f));
+            treeRotations.push_back(sceneryRandom(0.0f, 360.0f));
         }
     }
 }
@@ -267,6 +289,230 @@ void checkProgramLink(GLuint program) {
     }
 }
 
+// Cabeçalho comum dos shaders; defines de variantes (ex.: INSTANCED) entram logo depois dele
+const char* SHADER_VERSION = "#version 330 core\n";
+
+// Blocos de uniforms compartilhados (std140). FrameData é enviado uma vez por frame e DrawData
+// uma vez por desenho, num anel de faixas do mesmo buffer. Todo programa novo inclui os dois
+// textos em compileShader e ganha câmera, luz e neblina sem nenhum uniform extra.
+const GLuint FRAME_UBO_BINDING = 0;
+const GLuint DRAW_UBO_BINDING = 1;
+const int DRAW_UBO_RING_SLOTS = 1024;
+
+const char* FRAME_DATA_GLSL = R"(
+layout(std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    mat4 lightSpaceMatrices[4]; // MAX_SHADOW_CASCADES
+    vec4 cascadeSplits;         // Distância (espaço da câmera) onde cada cascata termina
+    vec4 shadowParams;          // x = número de cascatas, y = amostras do PCF, z = raio do PCF em texels
+    vec4 lightPos;
+    vec4 viewPos;
+    vec4 fogParams; // x = início, y = fim
+    vec4 fogColor;
+};
+)";
+
+const char* DRAW_DATA_GLSL = R"(
+layout(std140) uniform DrawData {
+    mat4 model;
+    vec4 objectColor;
+    vec4 drawParams; // x = brilho, y = usa textura
+};
+)";
+
+// Espelhos em C++ dos blocos acima (mesmo layout std140)
+struct FrameUniforms {
+    glm::mat4 view;
+    glm::mat4 projection;
+    glm::mat4 lightSpaceMatrices[MAX_SHADOW_CASCADES];
+    glm::vec4 cascadeSplits;
+    glm::vec4 shadowParams;
+    glm::vec4 lightPos;
+    glm::vec4 viewPos;
+    glm::vec4 fogParams;
+    glm::vec4 fogColor;
+};
+
+struct DrawUniforms {
+    glm::mat4 model;
+    glm::vec4 objectColor;
+    glm::vec4 drawParams;
+};
+
+// Neblina atmosférica
+const float FOG_START = 20.0f;
+const float FOG_END = 80.0f;
+const glm::vec3 FOG_COLOR(0.53f, 0.81f, 0.92f);
+
+GLuint frameUBO, drawUBO;
+GLsizeiptr drawSlotStride = 0;
+int drawSlotHead = 0;
+
+// Cria os buffers dos blocos e liga cada um ao seu binding point
+void setupUniformBuffers() {
+    glGenBuffers(1, &frameUBO);
+    glBindBuffer(GL_UNIFORM_BUFFER, frameUBO);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameUniforms), nullptr, GL_DYNAMIC_DRAW);
+    glBindBufferBase(GL_UNIFORM_BUFFER, FRAME_UBO_BINDING, frameUBO);
+
+    // Cada faixa do anel precisa começar num offset alinhado
+    GLint alignment = 256;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    drawSlotStride = (sizeof(DrawUniforms) + alignment - 1) / alignment * alignment;
+
+    glGenBuffers(1, &drawUBO);
+    glBindBuffer(GL_UNIFORM_BUFFER, drawUBO);
+    glBufferData(GL_UNIFORM_BUFFER, drawSlotStride * DRAW_UBO_RING_SLOTS, nullptr, GL_STREAM_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+// Envia os dados do frame e recomeça o anel de desenhos num buffer órfão
+void uploadFrameUniforms(const FrameUniforms& frame) {
+    glBindBuffer(GL_UNIFORM_BUFFER, frameUBO);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(FrameUniforms), &frame);
+    glBindBuffer(GL_UNIFORM_BUFFER, drawUBO);
+    glBufferData(GL_UNIFORM_BUFFER, drawSlotStride * DRAW_UBO_RING_SLOTS, nullptr, GL_STREAM_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    drawSlotHead = 0;
+}
+
+// Escreve os dados de um desenho na próxima faixa do anel e liga essa faixa ao bloco DrawData
+void setDrawUniforms(const glm::mat4& model, const glm::vec3& color = glm::vec3(1.0f), float brightness = 1.0f,
+                     bool useTexture = false) {
+    glBindBuffer(GL_UNIFORM_BUFFER, drawUBO);
+    if (drawSlotHead == DRAW_UBO_RING_SLOTS) {
+        glBufferData(GL_UNIFORM_BUFFER, drawSlotStride * DRAW_UBO_RING_SLOTS, nullptr, GL_STREAM_DRAW);
+        drawSlotHead = 0;
+    }
+    DrawUniforms draw = { model, glm::vec4(color, 1.0f), glm::vec4(brightness, useTexture ? 1.0f : 0.0f, 0.0f, 0.0f) };
+    GLintptr offset = drawSlotHead * drawSlotStride;
+    glBufferSubData(GL_UNIFORM_BUFFER, offset, sizeof(DrawUniforms), &draw);
+    glBindBufferRange(GL_UNIFORM_BUFFER, DRAW_UBO_BINDING, drawUBO, offset, sizeof(DrawUniforms));
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    drawSlotHead++;
+}
+
+// Compila um shader a partir de várias partes (versão, defines e corpo)
+GLuint compileShader(GLenum type, std::initializer_list<const char*> sources, const char* name) {
+    std::vector<const char*> parts(sources);
+    GLuint shader = glCreateShader(type);
+    glShaderSource(shader, static_cast<GLsizei>(parts.size()), parts.data(), nullptr);
+    glCompileShader(shader);
+    checkShaderCompile(shader, name);
+    return shader;
+}
+
+// Trocas de estado e desenhos do frame, zerados a cada frame e mostrados na janela "Desempenho"
+struct RenderStats {
+    int programBinds = 0, vaoBinds = 0, draws = 0;
+};
+RenderStats renderStats;
+
+// Programa de shader com as localizações dos uniforms resolvidas uma vez depois do link.
+// Os setters recebem um handle (índice em "uniforms"), guardam o último valor enviado
+// e pulam a chamada GL quando o valor não mudou. O programa precisa estar em uso ao chamar um setter.
+struct ShaderProgram {
+    struct Uniform {
+        std::string name;
+        GLint location = -1;
+        unsigned char value[sizeof(glm::mat4)];
+        bool valid = false;
+    };
+
+    GLuint id = 0;
+    std::vector<Uniform> uniforms;
+
+    // Enumera os uniforms ativos do programa linkado
+    void init(GLuint program) {
+        id = program;
+        uniforms.clear();
+        GLint count = 0;
+        glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &count);
+        for (GLint i = 0; i < count; ++i) {
+            char name[128];
+            GLsizei length = 0;
+            GLint size = 0;
+            GLenum type = 0;
+            glGetActiveUniform(program, i, sizeof(name), &length, &size, &type, name);
+            Uniform u;
+            u.name.assign(name, length);
+            // Arrays aparecem como "nome[0]"
+            size_t bracket = u.name.find('[');
+            if (bracket != std::string::npos) u.name.erase(bracket);
+            u.location = glGetUniformLocation(program, name);
+            if (u.location >= 0) uniforms.push_back(u);
+        }
+    }
+
+    // Handle do uniform, ou -1 se ele não existir/foi removido pelo compilador
+    int uniform(const char* name) const {
+        for (size_t i = 0; i < uniforms.size(); ++i) {
+            if (uniforms[i].name == name) return static_cast<int>(i);
+        }
+        return -1;
+    }
+
+    void use() const {
+        glUseProgram(id);
+        renderStats.programBinds++;
+    }
+
+    // Liga um bloco de uniforms do programa a um binding point (ignora blocos ausentes)
+    void bindBlock(const char* name, GLuint binding) const {
+        GLuint index = glGetUniformBlockIndex(id, name);
+        if (index != GL_INVALID_INDEX) glUniformBlockBinding(id, index, binding);
+    }
+
+    void setInt(int handle, int v) {
+        if (changed(handle, &v, sizeof(v))) glUniform1i(uniforms[handle].location, v);
+    }
+    void setFloat(int handle, float v) {
+        if (changed(handle, &v, sizeof(v))) glUniform1f(uniforms[handle].location, v);
+    }
+    void setVec3(int handle, const glm::vec3& v) {
+        if (changed(handle, &v, sizeof(v))) glUniform3fv(uniforms[handle].location, 1, &v[0]);
+    }
+    void setMat4(int handle, const glm::mat4& m) {
+        if (changed(handle, &m, sizeof(m))) glUniformMatrix4fv(uniforms[handle].location, 1, GL_FALSE, &m[0][0]);
+    }
+
+private:
+    // Atualiza o cache e diz se a chamada GL é necessária
+    bool changed(int handle, const void* data, size_t size) {
+        if (handle < 0) return false;
+        Uniform& u = uniforms[handle];
+        if (u.valid && std::memcmp(u.value, data, size) == 0) return false;
+        std::memcpy(u.value, data, size);
+        u.valid = true;
+        return true;
+    }
+};
+
+// Linka um programa e libera os shaders
+GLuint linkProgram(GLuint vertexShader, GLuint fragmentShader) {
+    GLuint program = glCreateProgram();
+    glAttachShader(program, vertexShader);
+    glAttachShader(program, fragmentShader);
+    glLinkProgram(program);
+    checkProgramLink(program);
+    glDeleteShader(vertexShader);
+    glDeleteShader(fragmentShader);
+    return program;
+}
+
+// Programa só de vertex shader cujas saídas vão, intercaladas, para o buffer de transform feedback
+GLuint linkTransformFeedbackProgram(GLuint vertexShader, std::initializer_list<const char*> varyings) {
+    std::vector<const char*> names(varyings);
+    GLuint program = glCreateProgram();
+    glAttachShader(program, vertexShader);
+    glTransformFeedbackVaryings(program, static_cast<GLsizei>(names.size()), names.data(), GL_INTERLEAVED_ATTRIBS);
+    glLinkProgram(program);
+    checkProgramLink(program);
+    glDeleteShader(vertexShader);
+    return program;
+}
+
 // ================== CALLBACKS DE INPUT E JANELA =============
 // Alterna entre tela cheia e janela ao pressionar F11
 void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods) {
@@ -354,45 +600,764 @@ void generateSphere(std::vector<float>& vertices, int segments = 20) {
     }
 }
 
-// Gera o chão como uma malha de quads
-void generateGround(std::vector<float>& vertices, int size = GROUND_SIZE, float quadSize = GROUND_QUAD_SIZE) {
-    for (int x = -size; x < size; ++x) {
-        for (int z = -size; z < size; ++z) {
-            float x0 = x * quadSize, x1 = (x + 1) * quadSize;
-            float z0 = z * quadSize, z1 = (z + 1) * quadSize;
-            float u0 = x + size, u1 = x + size + 1.0f;
-            float v0 = z + size, v1 = z + size + 1.0f;
+// Gera um quad unitário no plano XY (base dos billboards de partículas)
+void generateQuad(std::vector<float>& vertices) {
+    float quadData[] = {
+        -1,-1, 0, 0,0,1, 0,0,   1,-1, 0, 0,0,1, 1,0,   1, 1, 0, 0,0,1, 1,1,
+        -1,-1, 0, 0,0,1, 0,0,   1, 1, 0, 0,0,1, 1,1,  -1, 1, 0, 0,0,1, 0,1
+    };
+    vertices.assign(quadData, quadData + sizeof(quadData) / sizeof(float));
+}
+
+// Gera um chunk do chão: um único quad no plano XZ centrado na origem. A textura repete uma vez a cada
+// GROUND_QUAD_SIZE; como o chunk tem um número inteiro de repetições, chunks vizinhos emendam sem costura
+void generateGroundChunk(std::vector<float>& vertices, float chunkSize, float quadSize = GROUND_QUAD_SIZE) {
+    float h = chunkSize * 0.5f;
+    float t = chunkSize / quadSize;
+    float groundData[] = {
+        -h, 0, -h, 0,1,0, 0,0,   h, 0, -h, 0,1,0, t,0,   h, 0,  h, 0,1,0, t,t,
+        -h, 0, -h, 0,1,0, 0,0,   h, 0,  h, 0,1,0, t,t,  -h, 0,  h, 0,1,0, 0,t
+    };
+    vertices.assign(groundData, groundData + sizeof(groundData) / sizeof(float));
+}
+
+// ================ FRUSTUM CULLING ==================
+// Seis planos extraídos da matriz projeção * view (Gribb/Hartmann), com a normal apontando para dentro
+struct Frustum {
+    glm::vec4 planes[6];
+
+    void extract(const glm::mat4& m) {
+        glm::vec4 row0(m[0][0], m[1][0], m[2][0], m[3][0]);
+        glm::vec4 row1(m[0][1], m[1][1], m[2][1], m[3][1]);
+        glm::vec4 row2(m[0][2], m[1][2], m[2][2], m[3][2]);
+        glm::vec4 row3(m[0][3], m[1][3], m[2][3], m[3][3]);
+        planes[0] = row3 + row0; // esquerda
+        planes[1] = row3 - row0; // direita
+        planes[2] = row3 + row1; // baixo
+        planes[3] = row3 - row1; // cima
+        planes[4] = row3 + row2; // perto
+        planes[5] = row3 - row2; // longe
+        for (auto& p : planes) p /= glm::length(glm::vec3(p));
+    }
+
+    // Falso apenas se a caixa estiver inteira fora de algum plano
+    bool intersectsAABB(const glm::vec3& bmin, const glm::vec3& bmax) const {
+        for (const auto& p : planes) {
+            glm::vec3 positive(p.x >= 0.0f ? bmax.x : bmin.x,
+                               p.y >= 0.0f ? bmax.y : bmin.y,
+                               p.z >= 0.0f ? bmax.z : bmin.z);
+            if (glm::dot(glm::vec3(p), positive) + p.w < 0.0f) return false;
+        }
+        return true;
+    }
+
+    bool intersectsSphere(const glm::vec3& center, float radius) const {
+        for (const auto& p : planes) {
+            if (glm::dot(glm::vec3(p), center) + p.w < -radius) return false;
+        }
+        return true;
+    }
+};
+
+// Contadores de culling de uma passada, zerados a cada frame e mostrados na janela "Desempenho"
+struct CullStats {
+    int visible = 0, culled = 0;
+};
+CullStats cameraCull, shadowCull;
+
+// Passada principal (ver RenderQueue): opacos ordenados da frente para trás e pré-passe de profundidade opcional
+bool sortOpaque = true;    // Ordena os opacos da frente para trás
+bool depthPrepass = false; // Pré-passe só de profundidade e sombreamento com GL_EQUAL (--depth-prepass)
+
+// Fragmentos que passam no teste de profundidade na passada opaca (GL_SAMPLES_PASSED), ou seja, quantas vezes
+// o fragment shader principal rodou de fato. Cada frame usa uma query do anel e lê a mais antiga, que a GPU
+// já terminou, para comparar o custo de preenchimento com e sem pré-passe/ordenação sem travar o pipeline
+const int FRAGMENT_QUERIES = 3;
+
+struct FragmentCounter {
+    GLuint queries[FRAGMENT_QUERIES] = {};
+    int frame = 0;
+    GLuint samples = 0; // Resultado mais recente disponível
+
+    void begin() { glBeginQuery(GL_SAMPLES_PASSED, queries[frame % FRAGMENT_QUERIES]); }
+    void end() {
+        glEndQuery(GL_SAMPLES_PASSED);
+        frame++;
+        if (frame < FRAGMENT_QUERIES) return;
+        GLuint oldest = queries[frame % FRAGMENT_QUERIES];
+        GLint available = 0;
+        glGetQueryObjectiv(oldest, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (available) glGetQueryObjectuiv(oldest, GL_QUERY_RESULT, &samples);
+    }
+};
+FragmentCounter shadedFragments;
+
+// Tempos de frame e de simulação (ms) do jogo inteiro, resumidos em percentis ao sair. Os tempos vão para
+// histogramas de tamanho fixo (resolução de FRAME_STATS_BIN_MS), então registrar um frame nunca aloca
+const float FRAME_STATS_BIN_MS = 0.05f;
+const int FRAME_STATS_BINS = 4000; // Até 200 ms; acima disso cai no último
+
+struct TimeHistogram {
+    std::vector<unsigned int> bins = std::vector<unsigned int>(FRAME_STATS_BINS, 0);
+    unsigned long count = 0;
+    double sum = 0.0;
+    float max = 0.0f;
+
+    void add(float ms) {
+        int bin = std::min(static_cast<int>(ms / FRAME_STATS_BIN_MS), FRAME_STATS_BINS - 1);
+        bins[std::max(bin, 0)]++;
+        count++;
+        sum += ms;
+        max = std::max(max, ms);
+    }
 
-            vertices.insert(vertices.end(), {
-                x0, 0, z0, 0,1,0, u0, v0,  x1, 0, z0, 0,1,0, u1, v0,  x1, 0, z1, 0,1,0, u1, v1,
-                x0, 0, z0, 0,1,0, u0, v0,  x1, 0, z1, 0,1,0, u1, v1,  x0, 0, z1, 0,1,0, u0, v1
-                });
+    // Limite superior do bin onde cai o percentil p
+    float percentile(float p) const {
+        unsigned long target = static_cast<unsigned long>(std::ceil(p * count));
+        unsigned long seen = 0;
+        for (int i = 0; i < FRAME_STATS_BINS; ++i) {
+            seen += bins[i];
+            if (seen >= target && seen > 0) return std::min((i + 1) * FRAME_STATS_BIN_MS, max);
         }
+        return max;
+    }
+};
+
+struct FrameStats {
+    TimeHistogram frameMs, simMs;
+    float recentFrameMs = 0.0f; // Média móvel para a janela "Desempenho"
+
+    void add(float frame, float sim) {
+        frameMs.add(frame);
+        simMs.add(sim);
+        recentFrameMs = recentFrameMs == 0.0f ? frame : glm::mix(recentFrameMs, frame, 0.05f);
     }
+
+    void report(std::ostream& out) const {
+        auto line = [&](const char* name, const TimeHistogram& h) {
+            out << name << ": media " << h.sum / std::max<unsigned long>(h.count, 1)
+                << " ms, p50 " << h.percentile(0.50f) << ", p95 " << h.percentile(0.95f)
+                << ", p99 " << h.percentile(0.99f) << ", max " << h.max << "\n";
+        };
+        out << "Frames: " << frameMs.count << "\n";
+        line("Frame", frameMs);
+        line("Simulacao", simMs);
+    }
+};
+FrameStats frameStats;
+
+// Testa a esfera envolvente da malha levada ao mundo pela matriz model (raio escalado pelo maior eixo)
+bool isVisible(const Frustum& frustum, const MeshBounds& bounds, const glm::mat4& model, CullStats& stats) {
+    glm::vec3 center = glm::vec3(model * glm::vec4(bounds.center, 1.0f));
+    float scale = std::max({ glm::length(glm::vec3(model[0])), glm::length(glm::vec3(model[1])), glm::length(glm::vec3(model[2])) });
+    bool visible = frustum.intersectsSphere(center, bounds.radius * scale);
+    (visible ? stats.visible : stats.culled)++;
+    return visible;
 }
 
-// Configura o framebuffer e textura para shadow mapping
-void setupShadowMapping() {
-    glGenFramebuffers(1, &depthMapFBO);
-    glGenTextures(1, &depthMap);
-    glBindTexture(GL_TEXTURE_2D, depthMap);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, SHADOW_SIZE, SHADOW_SIZE, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+// Textura array de profundidade com uma camada por cascata, presa (camada 0) a um framebuffer sem cor
+void setupCascadeDepthTarget(GLuint& fbo, GLuint& texture) {
+    glGenFramebuffers(1, &fbo);
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, texture);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_DEPTH_COMPONENT, shadowCascadeSize, shadowCascadeSize, shadowCascades, 0,
+        GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
     float borderColor[] = { 1.0f, 1.0f, 1.0f, 1.0f };
-    glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);
+    glTexParameterfv(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BORDER_COLOR, borderColor);
 
-    glBindFramebuffer(GL_FRAMEBUFFER, depthMapFBO);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, depthMap, 0);
+    // A camada presa ao FBO é trocada a cada cascata na passada de sombra
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, texture, 0, 0);
     glDrawBuffer(GL_NONE);
     glReadBuffer(GL_NONE);
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
-// Carrega um modelo OBJ 
-bool loadOBJ(const std::string& path, std::vector<float>& vertices) {
+// Configura o depth map lido pelo shader principal e o cache das sombras estáticas, no mesmo formato (a cópia
+// entre os dois é um glBlitFramebuffer de profundidade). O depth map é lido com comparação: cada texture() no
+// shader devolve a fração lit das 4 amostras vizinhas, com interpolação bilinear (PCF do hardware)
+void setupShadowMapping() {
+    setupCascadeDepthTarget(depthMapFBO, depthMap);
+    setupCascadeDepthTarget(staticShadows.fbo, staticShadows.depthMap);
+
+    glBindTexture(GL_TEXTURE_2D_ARRAY, depthMap);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+}
+
+// Cascata de sombra: matriz da luz e distância (no espaço da câmera) onde a fatia termina
+struct ShadowCascade {
+    glm::mat4 lightSpace;
+    float splitFar;
+};
+
+// Divide [CAMERA_NEAR, SHADOW_DISTANCE] em shadowCascades fatias (mistura de divisão logarítmica e uniforme) e
+// ajusta uma caixa ortográfica da luz a cada uma. A caixa envolve a esfera da fatia, então o tamanho não muda
+// quando a câmera gira, e o centro anda em passos inteiros de texels no espaço da luz: as bordas das sombras não
+// tremem. O passo é grosso (SHADOW_CACHE_SLACK do raio, com a mesma folga na caixa), então a matriz da cascata
+// fica igual por vários frames e o cache das sombras estáticas continua valendo
+void fitShadowCascades(const glm::mat4& view, float aspectRatio, const glm::vec3& lightPos, ShadowCascade* cascades) {
+    // Luz direcional vinda de lightPos em direção à origem; a rotação é fixa e só a caixa se move
+    glm::vec3 lightDir = glm::normalize(lightPos);
+    glm::mat4 lightView = glm::lookAt(glm::vec3(0.0f), -lightDir, glm::vec3(0.0f, 1.0f, 0.0f));
+
+    float splitNear = CAMERA_NEAR;
+    for (int c = 0; c < shadowCascades; ++c) {
+        float t = static_cast<float>(c + 1) / shadowCascades;
+        float logSplit = CAMERA_NEAR * std::pow(SHADOW_DISTANCE / CAMERA_NEAR, t);
+        float uniformSplit = CAMERA_NEAR + (SHADOW_DISTANCE - CAMERA_NEAR) * t;
+        float splitFar = glm::mix(uniformSplit, logSplit, SHADOW_SPLIT_LAMBDA);
+
+        // Cantos da fatia em espaço do mundo
+        glm::mat4 inverseSlice = glm::inverse(
+            glm::perspective(glm::radians(FOV_DEGREES), aspectRatio, splitNear, splitFar) * view);
+        glm::vec3 corners[8];
+        glm::vec3 center(0.0f);
+        for (int i = 0; i < 8; ++i) {
+            glm::vec4 corner = inverseSlice * glm::vec4((i & 1) ? 1.0f : -1.0f, (i & 2) ? 1.0f : -1.0f, (i & 4) ? 1.0f : -1.0f, 1.0f);
+            corners[i] = glm::vec3(corner) / corner.w;
+            center += corners[i] / 8.0f;
+        }
+        float radius = 0.0f;
+        for (const glm::vec3& corner : corners) radius = std::max(radius, glm::length(corner - center));
+        radius = std::ceil(radius * 16.0f) / 16.0f; // Absorve a variação de arredondamento entre frames
+
+        float halfSize = radius * (1.0f + SHADOW_CACHE_SLACK);
+        float texel = 2.0f * halfSize / shadowCascadeSize;
+        float step = std::max(texel, std::floor(radius * SHADOW_CACHE_SLACK / texel) * texel);
+        glm::vec3 lightCenter = glm::floor(glm::vec3(lightView * glm::vec4(center, 1.0f)) / step) * step;
+
+        glm::mat4 lightProjection = glm::ortho(lightCenter.x - halfSize, lightCenter.x + halfSize,
+            lightCenter.y - halfSize, lightCenter.y + halfSize,
+            -lightCenter.z - halfSize - SHADOW_CASTER_MARGIN, -lightCenter.z + halfSize);
+        cascades[c].lightSpace = lightProjection * lightView;
+        cascades[c].splitFar = splitFar;
+        splitNear = splitFar;
+    }
+}
+
+// ================ CACHE BINÁRIO DE MALHAS ==================
+// O parse texto do OBJ domina o tempo de inicialização. Depois do primeiro carregamento, cada modelo é gravado
+// em "<modelo>.obj.meshcache": um cabeçalho seguido do bloco de vértices intercalados (pos, normal, uv = 8 floats)
+// e do bloco de índices. Nos carregamentos seguintes o arquivo é mapeado em memória e os blocos vão direto para o glBufferData.
+const uint32_t MESH_CACHE_MAGIC = 0x48534D43; // "CMSH"
+const uint32_t MESH_CACHE_VERSION = 5;
+const int MESH_VERTEX_FLOATS = 8;
+
+// Otimização de malhas (feita uma vez, antes de gravar o cache)
+const int VCACHE_OPTIMIZE_SIZE = 32;      // Cache LRU usado pela ordenação de Forsyth
+const int VCACHE_ANALYZE_SIZE = 16;       // Cache FIFO usado para medir ACMR/ATVR
+const bool MESH_OPTIMIZE_OVERDRAW = true; // Ordena clusters de triângulos para reduzir overdraw
+const size_t MESH_OVERDRAW_CLUSTER = 128; // Triângulos por cluster na ordenação de overdraw
+const float MESH_OVERDRAW_THRESHOLD = 1.05f; // Piora máxima de ACMR aceita pelos clusters em relação ao Forsyth
+
+// Estatísticas do cache de vértices antes/depois da otimização
+// ACMR = vértices transformados por triângulo, ATVR = vértices transformados por vértice único
+struct MeshStats {
+    float acmrBefore = 0.0f, acmrAfter = 0.0f;
+    float atvrBefore = 0.0f, atvrAfter = 0.0f;
+};
+
+struct MeshCacheHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t pathHash;    // FNV-1a do caminho do OBJ
+    int64_t sourceMTime;  // Data de modificação do OBJ
+    uint64_t sourceSize;  // Tamanho do OBJ em bytes
+    uint64_t vertexCount;
+    uint64_t indexCount;
+    MeshStats stats;
+    MeshBounds bounds;
+};
+
+// Arquivo somente leitura mapeado em memória
+struct MappedFile {
+    const unsigned char* data = nullptr;
+    size_t size = 0;
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = NULL;
+#else
+    int fd = -1;
+#endif
+
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile() { close(); }
+
+    bool open(const std::string& path) {
+        close();
+#ifdef _WIN32
+        file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (file == INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) { close(); return false; }
+        mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (!mapping) { close(); return false; }
+        data = static_cast<const unsigned char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        size = static_cast<size_t>(fileSize.QuadPart);
+#else
+        fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size == 0) { close(); return false; }
+        void* ptr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (ptr == MAP_FAILED) { close(); return false; }
+        data = static_cast<const unsigned char*>(ptr);
+        size = static_cast<size_t>(st.st_size);
+#endif
+        if (!data) { close(); return false; }
+        return true;
+    }
+
+    void close() {
+#ifdef _WIN32
+        if (data) UnmapViewOfFile(data);
+        if (mapping) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+        mapping = NULL;
+        file = INVALID_HANDLE_VALUE;
+#else
+        if (data) munmap(const_cast<unsigned char*>(data), size);
+        if (fd >= 0) ::close(fd);
+        fd = -1;
+#endif
+        data = nullptr;
+        size = 0;
+    }
+};
+
+// Vértices e índices de uma malha prontos para upload: em memória (OBJ recém processado ou forma gerada)
+// ou apontando direto para o cache mapeado
+struct MeshData {
+    std::vector<float> vertices;
+    std::vector<unsigned int> indices;
+    MappedFile cache;
+    const float* data = nullptr;
+    const unsigned int* indexData = nullptr;
+    size_t vertexCount = 0;
+    size_t indexCount = 0;
+    MeshStats stats;
+    MeshBounds bounds;
+};
+
+// Aponta a malha para os vetores em memória (depois de preencher mesh.vertices e mesh.indices)
+void useMeshVertices(MeshData& mesh) {
+    mesh.data = mesh.vertices.data();
+    mesh.vertexCount = mesh.vertices.size() / MESH_VERTEX_FLOATS;
+    mesh.indexData = mesh.indices.data();
+    mesh.indexCount = mesh.indices.size();
+}
+
+// Chave de solda: os 8 floats do vértice comparados bit a bit
+struct VertexKey {
+    float v[MESH_VERTEX_FLOATS];
+    bool operator==(const VertexKey& o) const { return std::memcmp(v, o.v, sizeof(v)) == 0; }
+};
+
+struct VertexKeyHash {
+    size_t operator()(const VertexKey& key) const {
+        uint64_t hash = 14695981039346656037ull;
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(key.v);
+        for (size_t i = 0; i < sizeof(key.v); ++i) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+        return static_cast<size_t>(hash);
+    }
+};
+
+// Calcula a AABB e a esfera envolvente dos vértices da malha
+void computeMeshBounds(MeshData& mesh) {
+    if (mesh.vertexCount == 0) { mesh.bounds = MeshBounds(); return; }
+    glm::vec3 bmin(mesh.data[0], mesh.data[1], mesh.data[2]), bmax = bmin;
+    for (size_t i = 1; i < mesh.vertexCount; ++i) {
+        const float* p = mesh.data + i * MESH_VERTEX_FLOATS;
+        bmin = glm::min(bmin, glm::vec3(p[0], p[1], p[2]));
+        bmax = glm::max(bmax, glm::vec3(p[0], p[1], p[2]));
+    }
+    glm::vec3 center = (bmin + bmax) * 0.5f;
+    float radius2 = 0.0f;
+    for (size_t i = 0; i < mesh.vertexCount; ++i) {
+        const float* p = mesh.data + i * MESH_VERTEX_FLOATS;
+        glm::vec3 d = glm::vec3(p[0], p[1], p[2]) - center;
+        radius2 = std::max(radius2, glm::dot(d, d));
+    }
+    mesh.bounds.min = bmin;
+    mesh.bounds.max = bmax;
+    mesh.bounds.center = center;
+    mesh.bounds.radius = std::sqrt(radius2);
+}
+
+// Solda vértices idênticos (pos, normal, uv) de uma lista de cantos de triângulos,
+// gerando vértices únicos e o buffer de índices
+void weldVertices(const float* corners, size_t cornerCount, MeshData& mesh) {
+    std::unordered_map<VertexKey, unsigned int, VertexKeyHash> unique;
+    unique.reserve(cornerCount);
+    mesh.vertices.clear();
+    mesh.indices.clear();
+    mesh.vertices.reserve(cornerCount * MESH_VERTEX_FLOATS);
+    mesh.indices.reserve(cornerCount);
+
+    for (size_t i = 0; i < cornerCount; ++i) {
+        VertexKey key;
+        std::memcpy(key.v, corners + i * MESH_VERTEX_FLOATS, sizeof(key.v));
+        // Normaliza -0.0f para 0.0f para não separar vértices iguais
+        for (float& f : key.v) if (f == 0.0f) f = 0.0f;
+
+        auto it = unique.find(key);
+        if (it == unique.end()) {
+            unsigned int index = static_cast<unsigned int>(unique.size());
+            unique.emplace(key, index);
+            mesh.vertices.insert(mesh.vertices.end(), key.v, key.v + MESH_VERTEX_FLOATS);
+            mesh.indices.push_back(index);
+        }
+        else {
+            mesh.indices.push_back(it->second);
+        }
+    }
+    mesh.vertices.shrink_to_fit();
+    useMeshVertices(mesh);
+    computeMeshBounds(mesh);
+}
+
+// Converte uma lista de triângulos não indexada (formas geradas) em malha indexada
+void weldVertices(const std::vector<float>& corners, MeshData& mesh) {
+    weldVertices(corners.data(), corners.size() / MESH_VERTEX_FLOATS, mesh);
+}
+
+// Hash FNV-1a de 64 bits
+uint64_t hashString(const std::string& text) {
+    uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : text) {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+// Monta o cabeçalho esperado para o OBJ atual; retorna false se o arquivo fonte não existir
+bool makeMeshCacheHeader(const std::string& path, MeshCacheHeader& header) {
+    std::error_code ec;
+    auto mtime = std::filesystem::last_write_time(path, ec);
+    if (ec) return false;
+    auto size = std::filesystem::file_size(path, ec);
+    if (ec) return false;
+
+    header.magic = MESH_CACHE_MAGIC;
+    header.version = MESH_CACHE_VERSION;
+    header.pathHash = hashString(path);
+    header.sourceMTime = static_cast<int64_t>(mtime.time_since_epoch().count());
+    header.sourceSize = static_cast<uint64_t>(size);
+    header.vertexCount = 0;
+    header.indexCount = 0;
+    header.stats = MeshStats();
+    header.bounds = MeshBounds();
+    return true;
+}
+
+// Tenta mapear o cache da malha; falha se ele não existir ou não corresponder mais ao OBJ
+bool loadMeshCache(const std::string& cachePath, const MeshCacheHeader& expected, MeshData& mesh) {
+    if (!mesh.cache.open(cachePath)) return false;
+
+    if (mesh.cache.size < sizeof(MeshCacheHeader)) { mesh.cache.close(); return false; }
+    MeshCacheHeader header;
+    std::memcpy(&header, mesh.cache.data, sizeof(header));
+
+    size_t expectedSize = sizeof(MeshCacheHeader) + header.vertexCount * MESH_VERTEX_FLOATS * sizeof(float) +
+        header.indexCount * sizeof(unsigned int);
+    if (header.magic != expected.magic || header.version != expected.version ||
+        header.pathHash != expected.pathHash || header.sourceMTime != expected.sourceMTime ||
+        header.sourceSize != expected.sourceSize || mesh.cache.size != expectedSize) {
+        mesh.cache.close();
+        return false;
+    }
+
+    mesh.data = reinterpret_cast<const float*>(mesh.cache.data + sizeof(MeshCacheHeader));
+    mesh.vertexCount = static_cast<size_t>(header.vertexCount);
+    mesh.indexData = reinterpret_cast<const unsigned int*>(mesh.data + mesh.vertexCount * MESH_VERTEX_FLOATS);
+    mesh.indexCount = static_cast<size_t>(header.indexCount);
+    mesh.stats = header.stats;
+    mesh.bounds = header.bounds;
+    return true;
+}
+
+// Grava o cache da malha (arquivo temporário + rename, para nunca deixar um cache pela metade)
+void writeMeshCache(const std::string& cachePath, MeshCacheHeader header, const MeshData& mesh) {
+    header.vertexCount = mesh.vertexCount;
+    header.indexCount = mesh.indexCount;
+    header.stats = mesh.stats;
+    header.bounds = mesh.bounds;
+    std::string tmpPath = cachePath + ".tmp";
+    {
+        std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            std::cerr << "Aviso: nao foi possivel gravar cache " << cachePath << std::endl;
+            return;
+        }
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(mesh.data), mesh.vertexCount * MESH_VERTEX_FLOATS * sizeof(float));
+        out.write(reinterpret_cast<const char*>(mesh.indexData), mesh.indexCount * sizeof(unsigned int));
+        if (!out) {
+            std::cerr << "Aviso: falha ao gravar cache " << cachePath << std::endl;
+            return;
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmpPath, cachePath, ec);
+    if (ec) std::filesystem::remove(tmpPath, ec);
+}
+
+// ================ OTIMIZAÇÃO DE MALHAS ==================
+// Simula um cache FIFO de vértices e retorna quantos vértices precisariam ser transformados
+size_t simulateVertexCache(const std::vector<unsigned int>& indices, size_t vertexCount, int cacheSize = VCACHE_ANALYZE_SIZE) {
+    std::vector<unsigned int> timestamp(vertexCount, 0);
+    unsigned int time = cacheSize + 1;
+    size_t misses = 0;
+    for (unsigned int v : indices) {
+        if (time - timestamp[v] > static_cast<unsigned int>(cacheSize)) {
+            timestamp[v] = time++;
+            misses++;
+        }
+    }
+    return misses;
+}
+
+// Pontuação de um vértice na heurística de Forsyth: favorece vértices recentes no cache
+// e vértices com poucos triângulos restantes (para não deixar "ilhas" para trás)
+float forsythVertexScore(int cachePosition, unsigned int remainingTriangles) {
+    if (remainingTriangles == 0) return -1.0f;
+
+    float score = 0.0f;
+    if (cachePosition >= 0) {
+        if (cachePosition < 3) {
+            score = 0.75f;
+        }
+        else {
+            float scaler = 1.0f / (VCACHE_OPTIMIZE_SIZE - 3);
+            score = powf(1.0f - (cachePosition - 3) * scaler, 1.5f);
+        }
+    }
+    score += 2.0f / sqrtf(static_cast<float>(remainingTriangles));
+    return score;
+}
+
+// Reordena os triângulos para localidade no cache pós-transformação (algoritmo linear de Tom Forsyth)
+void optimizeVertexCache(std::vector<unsigned int>& indices, size_t vertexCount) {
+    const size_t triCount = indices.size() / 3;
+    if (triCount == 0) return;
+
+    // Lista de triângulos de cada vértice (formato CSR)
+    std::vector<unsigned int> triOffset(vertexCount + 1, 0);
+    for (unsigned int v : indices) triOffset[v + 1]++;
+    for (size_t v = 0; v < vertexCount; ++v) triOffset[v + 1] += triOffset[v];
+
+    std::vector<unsigned int> adjacency(indices.size());
+    std::vector<unsigned int> remaining(vertexCount, 0);
+    for (size_t t = 0; t < triCount; ++t) {
+        for (int k = 0; k < 3; ++k) {
+            unsigned int v = indices[3 * t + k];
+            adjacency[triOffset[v] + remaining[v]++] = static_cast<unsigned int>(t);
+        }
+    }
+
+    std::vector<int> cachePosition(vertexCount, -1);
+    std::vector<float> vertexScore(vertexCount);
+    for (size_t v = 0; v < vertexCount; ++v) vertexScore[v] = forsythVertexScore(-1, remaining[v]);
+
+    std::vector<char> emitted(triCount, 0);
+
+    std::vector<unsigned int> result;
+    result.reserve(indices.size());
+    unsigned int cache[VCACHE_OPTIMIZE_SIZE + 3];
+    int cacheCount = 0;
+    size_t scanCursor = 0;
+    long long bestTri = -1;
+
+    while (result.size() < indices.size()) {
+        // Sem candidatos no cache: pega o próximo triângulo ainda não emitido na ordem dos índices. Fora do cache
+        // a pontuação só depende da valência, e uma busca pelo melhor a cada recomeço ficaria quadrática em
+        // malhas com muitas peças soltas (folhas)
+        if (bestTri < 0) {
+            while (emitted[scanCursor]) ++scanCursor;
+            bestTri = static_cast<long long>(scanCursor);
+        }
+
+        const unsigned int* tri = &indices[3 * bestTri];
+        emitted[bestTri] = 1;
+        result.insert(result.end(), tri, tri + 3);
+
+        // Remove o triângulo das listas ativas dos seus vértices
+        for (int k = 0; k < 3; ++k) {
+            unsigned int v = tri[k];
+            unsigned int* begin = &adjacency[triOffset[v]];
+            unsigned int* end = begin + remaining[v];
+            unsigned int* it = std::find(begin, end, static_cast<unsigned int>(bestTri));
+            if (it != end) {
+                *it = *(end - 1);
+                remaining[v]--;
+            }
+        }
+
+        // Novo cache: vértices do triângulo na frente, seguidos do cache antigo
+        unsigned int newCache[VCACHE_OPTIMIZE_SIZE + 3];
+        int newCount = 0;
+        for (int k = 0; k < 3; ++k) {
+            if (std::find(newCache, newCache + newCount, tri[k]) == newCache + newCount) newCache[newCount++] = tri[k];
+        }
+        for (int i = 0; i < cacheCount; ++i) {
+            if (cache[i] != tri[0] && cache[i] != tri[1] && cache[i] != tri[2]) newCache[newCount++] = cache[i];
+        }
+
+        for (int i = 0; i < newCount; ++i) {
+            unsigned int v = newCache[i];
+            cachePosition[v] = (i < VCACHE_OPTIMIZE_SIZE) ? i : -1;
+            vertexScore[v] = forsythVertexScore(cachePosition[v], remaining[v]);
+        }
+
+        // Reavalia os triângulos tocados pelo cache e escolhe o melhor
+        bestTri = -1;
+        float bestScore = -1.0f;
+        for (int i = 0; i < newCount; ++i) {
+            unsigned int v = newCache[i];
+            for (unsigned int a = 0; a < remaining[v]; ++a) {
+                unsigned int t = adjacency[triOffset[v] + a];
+                float score = vertexScore[indices[3 * t]] + vertexScore[indices[3 * t + 1]] + vertexScore[indices[3 * t + 2]];
+                if (score > bestScore) {
+                    bestScore = score;
+                    bestTri = t;
+                }
+            }
+        }
+
+        cacheCount = std::min(newCount, VCACHE_OPTIMIZE_SIZE);
+        std::copy(newCache, newCache + cacheCount, cache);
+    }
+    indices.swap(result);
+}
+
+// Ordena clusters de triângulos para reduzir overdraw: clusters virados para fora da malha
+// (que tendem a cobrir os internos) são desenhados primeiro. Os clusters são fatias contínuas
+// da ordem já otimizada para o cache, então a localidade de vértices é quase toda preservada.
+void optimizeOverdraw(std::vector<unsigned int>& indices, const std::vector<float>& vertices,
+                      size_t clusterTriangles = MESH_OVERDRAW_CLUSTER) {
+    const size_t triCount = indices.size() / 3;
+    const size_t clusterCount = (triCount + clusterTriangles - 1) / clusterTriangles;
+    if (clusterCount < 2) return;
+
+    auto position = [&](unsigned int v) {
+        const float* p = &vertices[v * MESH_VERTEX_FLOATS];
+        return glm::vec3(p[0], p[1], p[2]);
+    };
+
+    glm::vec3 meshCenter(0.0f);
+    for (unsigned int v : indices) meshCenter += position(v);
+    meshCenter /= static_cast<float>(indices.size());
+
+    std::vector<std::pair<float, size_t>> order(clusterCount);
+    for (size_t c = 0; c < clusterCount; ++c) {
+        size_t first = c * clusterTriangles;
+        size_t last = std::min(first + clusterTriangles, triCount);
+        glm::vec3 center(0.0f), normal(0.0f);
+        for (size_t t = first; t < last; ++t) {
+            glm::vec3 a = position(indices[3 * t]), b = position(indices[3 * t + 1]), c2 = position(indices[3 * t + 2]);
+            center += (a + b + c2) / 3.0f;
+            normal += glm::cross(b - a, c2 - a); // Ponderada pela área
+        }
+        center /= static_cast<float>(last - first);
+        float normalLength = glm::length(normal);
+        float facing = (normalLength > 0.0f) ? glm::dot(center - meshCenter, normal / normalLength) : 0.0f;
+        order[c] = { -facing, c };
+    }
+    std::stable_sort(order.begin(), order.end(),
+        [](const std::pair<float, size_t>& a, const std::pair<float, size_t>& b) { return a.first < b.first; });
+
+    std::vector<unsigned int> result;
+    result.reserve(indices.size());
+    for (const auto& entry : order) {
+        size_t first = entry.second * clusterTriangles * 3;
+        size_t last = std::min(first + clusterTriangles * 3, indices.size());
+        result.insert(result.end(), indices.begin() + first, indices.begin() + last);
+    }
+    indices.swap(result);
+}
+
+// Reordena os vértices na ordem do primeiro uso pelos índices (localidade de fetch);
+// vértices não referenciados são descartados
+void optimizeVertexFetch(std::vector<float>& vertices, std::vector<unsigned int>& indices) {
+    size_t vertexCount = vertices.size() / MESH_VERTEX_FLOATS;
+    std::vector<unsigned int> remap(vertexCount, UINT_MAX);
+    std::vector<float> result;
+    result.reserve(vertices.size());
+    unsigned int next = 0;
+    for (unsigned int& v : indices) {
+        if (remap[v] == UINT_MAX) {
+            remap[v] = next++;
+            const float* src = &vertices[v * MESH_VERTEX_FLOATS];
+            result.insert(result.end(), src, src + MESH_VERTEX_FLOATS);
+        }
+        v = remap[v];
+    }
+    vertices.swap(result);
+}
+
+// Roda todas as etapas de otimização numa malha indexada em memória e mede o ganho
+void optimizeMesh(MeshData& mesh) {
+    size_t triCount = mesh.indices.size() / 3;
+    size_t vertexCount = mesh.vertices.size() / MESH_VERTEX_FLOATS;
+    if (triCount == 0 || vertexCount == 0) return;
+
+    size_t missesBefore = simulateVertexCache(mesh.indices, vertexCount);
+    mesh.stats.acmrBefore = static_cast<float>(missesBefore) / triCount;
+    mesh.stats.atvrBefore = static_cast<float>(missesBefore) / vertexCount;
+
+    // Só mantém a ordem original se o próprio Forsyth perder para ela
+    std::vector<unsigned int> originalIndices = mesh.indices;
+    optimizeVertexCache(mesh.indices, vertexCount);
+    size_t missesForsyth = simulateVertexCache(mesh.indices, vertexCount);
+    if (missesForsyth > missesBefore) {
+        mesh.indices.swap(originalIndices);
+    } else if (MESH_OPTIMIZE_OVERDRAW) {
+        // Malhas que já saem quase ótimas do Forsyth (ex.: folhas soltas) podem piorar com os clusters;
+        // nesse caso volta para a ordem do Forsyth
+        std::vector<unsigned int> forsythIndices = mesh.indices;
+        optimizeOverdraw(mesh.indices, mesh.vertices);
+        if (simulateVertexCache(mesh.indices, vertexCount) > missesForsyth * MESH_OVERDRAW_THRESHOLD) mesh.indices.swap(forsythIndices);
+    }
+
+    optimizeVertexFetch(mesh.vertices, mesh.indices);
+    useMeshVertices(mesh);
+
+    size_t missesAfter = simulateVertexCache(mesh.indices, mesh.vertexCount);
+    mesh.stats.acmrAfter = static_cast<float>(missesAfter) / triCount;
+    mesh.stats.atvrAfter = static_cast<float>(missesAfter) / mesh.vertexCount;
+}
+
+// Mostra o ganho de cache de vértices de um modelo
+void printMeshStats(const std::string& path, const MeshStats& stats, bool fromCache) {
+    std::cout << "  Malha " << std::filesystem::path(path).filename().string()
+              << (fromCache ? " (cache)" : "")
+              << ": ACMR " << stats.acmrBefore << " -> " << stats.acmrAfter
+              << ", ATVR " << stats.atvrBefore << " -> " << stats.atvrAfter << std::endl;
+}
+
+// Carrega um modelo OBJ (do cache binário quando ele estiver válido)
+bool loadOBJ(const std::string& path, MeshData& mesh) {
+    std::string cachePath = path + ".meshcache";
+    MeshCacheHeader header;
+    bool cacheable = makeMeshCacheHeader(path, header);
+    if (cacheable && loadMeshCache(cachePath, header, mesh)) {
+        printMeshStats(path, mesh.stats, true);
+        return true;
+    }
+
     tinyobj::attrib_t attrib;
     std::vector<tinyobj::shape_t> shapes;
     std::vector<tinyobj::material_t> materials;
@@ -403,44 +1368,62 @@ bool loadOBJ(const std::string& path, std::vector<float>& vertices) {
         return false;
     }
 
+    size_t cornerCount = 0;
+    for (const auto& shape : shapes) cornerCount += shape.mesh.indices.size() / 3 * 3;
+
+    std::vector<float> corners(cornerCount * MESH_VERTEX_FLOATS);
+    float* out = corners.data();
+
     for (const auto& shape : shapes) {
         for (size_t f = 0; f < shape.mesh.indices.size() / 3; f++) {
             for (size_t v = 0; v < 3; v++) {
                 auto idx = shape.mesh.indices[3 * f + v];
 
-                vertices.push_back(attrib.vertices[3 * idx.vertex_index + 0]);
-                vertices.push_back(attrib.vertices[3 * idx.vertex_index + 1]);
-                vertices.push_back(attrib.vertices[3 * idx.vertex_index + 2]);
+                out[0] = attrib.vertices[3 * idx.vertex_index + 0];
+                out[1] = attrib.vertices[3 * idx.vertex_index + 1];
+                out[2] = attrib.vertices[3 * idx.vertex_index + 2];
 
                 if (idx.normal_index >= 0) {
-                    vertices.push_back(attrib.normals[3 * idx.normal_index + 0]);
-                    vertices.push_back(attrib.normals[3 * idx.normal_index + 1]);
-                    vertices.push_back(attrib.normals[3 * idx.normal_index + 2]);
+                    out[3] = attrib.normals[3 * idx.normal_index + 0];
+                    out[4] = attrib.normals[3 * idx.normal_index + 1];
+                    out[5] = attrib.normals[3 * idx.normal_index + 2];
                 }
                 else {
-                    vertices.insert(vertices.end(), { 0.0f, 1.0f, 0.0f });
+                    out[3] = 0.0f; out[4] = 1.0f; out[5] = 0.0f;
                 }
 
                 if (idx.texcoord_index >= 0) {
-                    vertices.push_back(attrib.texcoords[2 * idx.texcoord_index + 0]);
-                    vertices.push_back(attrib.texcoords[2 * idx.texcoord_index + 1]);
+                    out[6] = attrib.texcoords[2 * idx.texcoord_index + 0];
+                    out[7] = attrib.texcoords[2 * idx.texcoord_index + 1];
                 }
                 else {
-                    vertices.insert(vertices.end(), { 0.0f, 0.0f });
+                    out[6] = 0.0f; out[7] = 0.0f;
                 }
+                out += MESH_VERTEX_FLOATS;
             }
         }
     }
+    weldVertices(corners, mesh);
+    optimizeMesh(mesh);
+    computeMeshBounds(mesh);
+    printMeshStats(path, mesh.stats, false);
+
+    if (cacheable) writeMeshCache(cachePath, header, mesh);
     return true;
 }
 
-// Cria e configura VAO/VBO para um objeto
-void setupVAO(GLuint& vao, GLuint& vbo, const std::vector<float>& data) {
-    glGenVertexArrays(1, &vao);
-    glGenBuffers(1, &vbo);
-    glBindVertexArray(vao);
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glBufferData(GL_ARRAY_BUFFER, data.size() * sizeof(float), data.data(), GL_STATIC_DRAW);
+// Cria e configura VAO/VBO/EBO para uma malha
+void setupMesh(Mesh& mesh, const MeshData& data) {
+    glGenVertexArrays(1, &mesh.vao);
+    glGenBuffers(1, &mesh.vbo);
+    glGenBuffers(1, &mesh.ebo);
+    glBindVertexArray(mesh.vao);
+    glBindBuffer(GL_ARRAY_BUFFER, mesh.vbo);
+    glBufferData(GL_ARRAY_BUFFER, data.vertexCount * MESH_VERTEX_FLOATS * sizeof(float), data.data, GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.ebo);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, data.indexCount * sizeof(unsigned int), data.indexData, GL_STATIC_DRAW);
+    mesh.indexCount = static_cast<GLsizei>(data.indexCount);
+    mesh.bounds = data.bounds;
 
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
     glEnableVertexAttribArray(0);
@@ -449,416 +1432,495 @@ void setupVAO(GLuint& vao, GLuint& vbo, const std::vector<float>& data) {
     glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
     glEnableVertexAttribArray(2);
 
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    // O EBO fica associado ao VAO, então só o VBO é desvinculado
     glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
-// ================ LÓGICA DO JOGO ==================
-// Verifica se uma posição está livre para spawn (aparecimento) de objeto
-bool checkPositionFree(glm::vec3 pos, float minDistance = 2.5f) {
-    for (const auto& obs : obstacles) {
-        if (obs.active && glm::length(glm::vec2(obs.position.x - pos.x, obs.position.z - pos.z)) < minDistance) {
-            return false;
-        }
-    }
-    for (const auto& col : collectibles) {
-        if (col.active && glm::length(glm::vec2(col.position.x - pos.x, col.position.z - pos.z)) < minDistance) {
-            return false;
-        }
-    }
-    return true;
+// Desenha uma malha indexada
+void drawMesh(const Mesh& mesh) {
+    glBindVertexArray(mesh.vao);
+    glDrawElements(GL_TRIANGLES, mesh.indexCount, GL_UNSIGNED_INT, (void*)0);
+    renderStats.vaoBinds++;
+    renderStats.draws++;
 }
 
-// Spawna aliens ou moedas no cenário
-void spawnObject(int type) {
-    if (type == 0) {
-        // REDUZIDO: 1 a 3 aliens por spawn (menos poluído)
-        int numAliens = 1 + rand() % 3;
+// VAO das partículas: quad unitário + um buffer de instâncias por campo do pool, com divisor 1
+void setupParticleInstancing(const Mesh& quad) {
+    glGenVertexArrays(1, &particleVAO);
+    glGenBuffers(PARTICLE_BUFFER_COUNT, particleInstanceVBOs);
+    glBindVertexArray(particleVAO);
+
+    glBindBuffer(GL_ARRAY_BUFFER, quad.vbo);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, quad.ebo);
+
+    // Atributos 3 a 6: posição, cor, tamanho e vida
+    const GLint components[PARTICLE_BUFFER_COUNT] = { 3, 3, 1, 1 };
+    for (int i = 0; i < PARTICLE_BUFFER_COUNT; ++i) {
+        glBindBuffer(GL_ARRAY_BUFFER, particleInstanceVBOs[i]);
+        glVertexAttribPointer(3 + i, components[i], GL_FLOAT, GL_FALSE, components[i] * sizeof(float), (void*)0);
+        glEnableVertexAttribArray(3 + i);
+        glVertexAttribDivisor(3 + i, 1);
+    }
 
-        for (int i = 0; i < numAliens; i++) {
-            GameObject obj;
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
 
-            obj.position.x = randomFloat(-8.0f, 8.0f);
-            obj.position.y = randomFloat(0.5f, 1.2f);
-            obj.position.z = randomFloat(-38.0f, -32.0f);
+// Envia os campos vivos de um pool e desenha todas as partículas numa chamada. glBufferData com os dados
+// faz o orphaning: o driver entrega um buffer novo em vez de esperar a GPU terminar com o anterior
+void drawParticlePool(const ParticlePool& pool, const Mesh& quad) {
+    if (pool.count == 0) return;
+    const void* fields[PARTICLE_BUFFER_COUNT] = { pool.position.data(), pool.color.data(), pool.size.data(), pool.lifetime.data() };
+    const size_t fieldSizes[PARTICLE_BUFFER_COUNT] = { sizeof(glm::vec3), sizeof(glm::vec3), sizeof(float), sizeof(float) };
+    for (int i = 0; i < PARTICLE_BUFFER_COUNT; ++i) {
+        glBindBuffer(GL_ARRAY_BUFFER, particleInstanceVBOs[i]);
+        glBufferData(GL_ARRAY_BUFFER, pool.count * fieldSizes[i], fields[i], GL_STREAM_DRAW);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
 
-            if (!checkPositionFree(obj.position, 1.8f)) continue;
+    glBindVertexArray(particleVAO);
+    glDrawElementsInstanced(GL_TRIANGLES, quad.indexCount, GL_UNSIGNED_INT, (void*)0, pool.count);
+    renderStats.vaoBinds++;
+    renderStats.draws++;
+}
 
-            obj.active = true;
-            obj.type = 0;
+// ================== PARTÍCULAS NA GPU ==================
+// Backend opcional: o estado de cada sistema fica em dois buffers na GPU e um vertex shader com transform
+// feedback avança as partículas de um para o outro (ping-pong), sem envio por frame. A CPU só manda os registros
+// de spawn (ParticlePool::spawned), gravados num anel por cima das partículas mais antigas. As mortas ficam no
+// buffer com vida <= 0: o update as mantém mortas e o desenho as descarta.
+static_assert(sizeof(Particle) == 11 * sizeof(float), "Particle é o layout do buffer de partículas na GPU");
+
+struct GpuParticleSystem {
+    GLuint buffers[2] = { 0, 0 };
+    GLuint updateVAO[2] = { 0, 0 }; // Lê buffers[i] como atributos do update
+    GLuint drawVAO[2] = { 0, 0 };   // Quad + buffers[i] como instâncias
+    int current = 0;                // Buffer com o estado mais recente
+    int capacity = 0;
+    int used = 0;                   // Slots já escritos; update e desenho só passam por eles
+    int cursor = 0;                 // Próximo slot do anel de spawn
+    float liveTime = 0.0f;          // Segundos até a partícula enviada mais longeva morrer; em 0 o sistema esvazia
+    unsigned int epoch = 0;         // ParticlePool::epoch da última sincronização
+};
 
-            // VARIAÇÃO DE TAMANHO: alguns aliens são MUITO maiores!
-            float sizeCategory = randomFloat(0.0f, 1.0f);
-            float scaleVariation;
+// Handles dos uniforms do update, resolvidos uma vez na criação do programa
+struct GpuParticleUniforms {
+    int pulse, gameTime, deltaTime, decay, gravity, shrinkStep;
+};
 
-            if (sizeCategory < 0.6f) {
-                // 60% - aliens normais
-                scaleVariation = randomFloat(0.8f, 1.2f);
-            }
-            else if (sizeCategory < 0.85f) {
-                // 25% - aliens grandes
-                scaleVariation = randomFloat(1.3f, 1.8f);
-            }
-            else {
-                // 15% - aliens GIGANTES!
-                scaleVariation = randomFloat(1.9f, 2.5f);
-            }
+GpuParticleUniforms gpuParticleUniforms(const ShaderProgram& program) {
+    return { program.uniform("pulse"), program.uniform("gameTime"), program.uniform("deltaTime"),
+             program.uniform("decay"), program.uniform("gravity"), program.uniform("shrinkStep") };
+}
+const int GPU_PARTICLE_SYSTEMS = 4; // Propulsor, velocidade, coleta, explosão
+GpuParticleSystem gpuParticles[GPU_PARTICLE_SYSTEMS];
+
+void setupGpuParticleSystem(GpuParticleSystem& system, int capacity, const Mesh& quad) {
+    system.capacity = capacity;
+    std::vector<Particle> empty(std::max(capacity, 1)); // Vida 0: todos os slots começam mortos
+    glGenBuffers(2, system.buffers);
+    glGenVertexArrays(2, system.updateVAO);
+    glGenVertexArrays(2, system.drawVAO);
+
+    const GLsizei stride = sizeof(Particle);
+    for (int i = 0; i < 2; ++i) {
+        glBindBuffer(GL_ARRAY_BUFFER, system.buffers[i]);
+        glBufferData(GL_ARRAY_BUFFER, empty.size() * stride, empty.data(), GL_DYNAMIC_COPY);
+
+        // Update: atributos 0 a 4 na ordem dos campos de Particle
+        glBindVertexArray(system.updateVAO[i]);
+        const GLint components[] = { 3, 3, 3, 1, 1 };
+        const size_t offsets[] = { offsetof(Particle, position), offsetof(Particle, velocity), offsetof(Particle, color),
+                                   offsetof(Particle, size), offsetof(Particle, lifetime) };
+        for (int a = 0; a < 5; ++a) {
+            glVertexAttribPointer(a, components[a], GL_FLOAT, GL_FALSE, stride, (void*)offsets[a]);
+            glEnableVertexAttribArray(a);
+        }
 
-            obj.scale = glm::vec3(0.8f * scaleVariation, 1.5f * scaleVariation, 0.8f * scaleVariation);
-            obj.rotation = randomFloat(0.0f, 360.0f);
+        // Desenho: mesmos atributos 3 a 6 do VAO das partículas da CPU (posição, cor, tamanho, vida)
+        glBindVertexArray(system.drawVAO[i]);
+        glBindBuffer(GL_ARRAY_BUFFER, quad.vbo);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
+        glEnableVertexAttribArray(0);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, quad.ebo);
+        glBindBuffer(GL_ARRAY_BUFFER, system.buffers[i]);
+        const GLint drawComponents[] = { 3, 3, 1, 1 };
+        const size_t drawOffsets[] = { offsetof(Particle, position), offsetof(Particle, color),
+                                       offsetof(Particle, size), offsetof(Particle, lifetime) };
+        for (int a = 0; a < 4; ++a) {
+            glVertexAttribPointer(3 + a, drawComponents[a], GL_FLOAT, GL_FALSE, stride, (void*)drawOffsets[a]);
+            glEnableVertexAttribArray(3 + a);
+            glVertexAttribDivisor(3 + a, 1);
+        }
+    }
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
 
-            obj.color = glm::vec3(
-                randomFloat(0.7f, 0.95f),
-                randomFloat(0.1f, 0.3f),
-                randomFloat(0.1f, 0.2f)
-            );
+void deleteGpuParticleSystem(GpuParticleSystem& system) {
+    glDeleteBuffers(2, system.buffers);
+    glDeleteVertexArrays(2, system.updateVAO);
+    glDeleteVertexArrays(2, system.drawVAO);
+    system = GpuParticleSystem();
+}
 
-            obstacles.push_back(obj);
+// Grava os spawns novos do pool no anel do buffer atual (descarta tudo se a partida recomeçou)
+void appendGpuParticles(GpuParticleSystem& system, ParticlePool& pool) {
+    if (system.epoch != pool.epoch) {
+        system.epoch = pool.epoch;
+        system.used = 0;
+        system.cursor = 0;
+        system.liveTime = 0.0f;
+    }
+    if (system.capacity == 0) {
+        pool.spawned.clear();
+        return;
+    }
 
-            // Incrementa contador para moedas raras
-            alienSpawnCount++;
-        }
+    for (const Particle& p : pool.spawned) {
+        float liveTime = (pool.decay > 0.0f) ? p.lifetime / pool.decay : FLT_MAX;
+        system.liveTime = std::max(system.liveTime, liveTime);
     }
-    else {
-        // MOEDAS RARAS: apenas 1 a cada ~10 aliens
-        if (alienSpawnCount < 10) {
-            return; // Não spawna moeda ainda
-        }
 
-        // Reseta contador
-        alienSpawnCount = 0;
-
-        int attempts = 0;
-        glm::vec3 pos;
-        do {
-            pos = glm::vec3(randomFloat(-8.0f, 8.0f), 0.7f, randomFloat(-38.0f, -32.0f));
-            attempts++;
-        } while (!checkPositionFree(pos) && attempts < 10);
-
-        if (attempts < 10) {
-            GameObject obj;
-            obj.position = pos;
-            obj.active = true;
-            obj.type = 1;
-            obj.scale = glm::vec3(0.8f);
-            obj.color = glm::vec3(1.0f, 0.84f, 0.0f);
-            obj.rotation = 0.0f;
-            collectibles.push_back(obj);
-        }
+    glBindBuffer(GL_ARRAY_BUFFER, system.buffers[system.current]);
+    int remaining = static_cast<int>(pool.spawned.size());
+    const Particle* data = pool.spawned.data();
+    while (remaining > 0) {
+        int n = std::min(remaining, system.capacity - system.cursor);
+        glBufferSubData(GL_ARRAY_BUFFER, system.cursor * sizeof(Particle), n * sizeof(Particle), data);
+        data += n;
+        remaining -= n;
+        system.cursor = (system.cursor + n) % system.capacity;
+        system.used = std::min(system.capacity, system.used + n);
     }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    pool.spawned.clear();
 }
 
-// Cria partículas de explosão na posição informada
-void createExplosion(glm::vec3 position) {
-    for (int i = 0; i < 40; ++i) {
-        ExplosionParticle p;
-        p.position = position;
+// Avança os slots usados por deltaTime segundos: buffer atual -> outro buffer, sem rasterizar.
+// pulse recalcula a cor pulsante do propulsor, como ParticlePool faz na CPU
+void updateGpuParticles(GpuParticleSystem& system, ShaderProgram& program, const GpuParticleUniforms& uniforms,
+                        const ParticlePool& pool, float deltaTime, bool pulse, float gameTime) {
+    if (system.used == 0 || deltaTime <= 0.0f) return;
+
+    // Sem spawns novos por mais tempo que a vida mais longa, todos os slots estão mortos: o anel recomeça
+    // vazio e sistemas ociosos (coleta, explosão) deixam de varrer a capacidade inteira a cada frame
+    system.liveTime -= deltaTime;
+    if (system.liveTime <= 0.0f) {
+        system.used = 0;
+        system.cursor = 0;
+        system.liveTime = 0.0f;
+        return;
+    }
 
-        float angle = randomFloat(0.0f, 2.0f * M_PI);
-        float speed = randomFloat(1.5f, 4.0f);
-        float elevation = randomFloat(-0.5f, 1.5f);
+    program.setFloat(uniforms.pulse, pulse ? 1.0f : 0.0f);
+    program.setFloat(uniforms.gameTime, gameTime);
+    program.setFloat(uniforms.deltaTime, deltaTime);
+    program.setFloat(uniforms.decay, pool.decay);
+    program.setFloat(uniforms.gravity, pool.gravity);
+    program.setFloat(uniforms.shrinkStep, perFrameFactor(pool.shrink, deltaTime));
+
+    glBindVertexArray(system.updateVAO[system.current]);
+    glBindBufferRange(GL_TRANSFORM_FEEDBACK_BUFFER, 0, system.buffers[1 - system.current], 0, system.used * sizeof(Particle));
+    glBeginTransformFeedback(GL_POINTS);
+    glDrawArrays(GL_POINTS, 0, system.used);
+    renderStats.vaoBinds++;
+    renderStats.draws++;
+    glEndTransformFeedback();
+    glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+    system.current = 1 - system.current;
+}
 
-        p.velocity = glm::vec3(
-            cos(angle) * speed,
-            elevation + randomFloat(0.5f, 2.5f),
-            sin(angle) * speed
-        );
+// Um passo fixo do backend na GPU, chamado logo depois de cada passo da simulação: envia os spawns do passo
+// e avança os sistemas por ele. Como no ParticlePool, cada partícula só envelhece nos passos em que já existia
+void stepGpuParticles(ShaderProgram& program, const GpuParticleUniforms& uniforms, GameWorld& world, float deltaTime) {
+    ParticlePool* pools[GPU_PARTICLE_SYSTEMS] = { &world.thrusterParticles, &world.speedParticles,
+                                                  &world.collectParticles, &world.explosionParticles };
+    program.use();
+    glEnable(GL_RASTERIZER_DISCARD);
+    for (int i = 0; i < GPU_PARTICLE_SYSTEMS; ++i) {
+        appendGpuParticles(gpuParticles[i], *pools[i]);
+        updateGpuParticles(gpuParticles[i], program, uniforms, *pools[i], deltaTime, pools[i] == &world.thrusterParticles,
+                           world.gameTime);
+    }
+    glDisable(GL_RASTERIZER_DISCARD);
+}
 
-        p.size = randomFloat(0.08f, 0.18f);
-        p.lifetime = randomFloat(0.8f, 1.5f);
+void drawGpuParticles(const GpuParticleSystem& system, const Mesh& quad) {
+    if (system.used == 0) return;
+    glBindVertexArray(system.drawVAO[system.current]);
+    glDrawElementsInstanced(GL_TRIANGLES, quad.indexCount, GL_UNSIGNED_INT, (void*)0, system.used);
+    renderStats.vaoBinds++;
+    renderStats.draws++;
+}
 
-        // Cores variadas da explosão
-        float colorType = randomFloat(0.0f, 1.0f);
-        if (colorType < 0.4f) {
-            p.color = glm::vec3(1.0f, 0.3f, 0.1f); // Laranja
-        }
-        else if (colorType < 0.7f) {
-            p.color = glm::vec3(1.0f, 0.8f, 0.2f); // Amarelo
-        }
-        else {
-            p.color = glm::vec3(0.9f, 0.1f, 0.1f); // Vermelho
-        }
+// Cria o VAO instanciado de uma malha e envia as matrizes model das instâncias
+void setupInstancedMesh(InstancedMesh& inst, const Mesh& mesh, const std::vector<glm::mat4>& models, GLenum usage) {
+    glGenVertexArrays(1, &inst.vao);
+    glGenBuffers(1, &inst.instanceVBO);
+    glBindVertexArray(inst.vao);
 
-        explosionParticles.push_back(p);
+    glBindBuffer(GL_ARRAY_BUFFER, mesh.vbo);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
+    glEnableVertexAttribArray(2);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.ebo);
+
+    // Uma mat4 ocupa quatro atributos vec4 consecutivos
+    glBindBuffer(GL_ARRAY_BUFFER, inst.instanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, models.size() * sizeof(glm::mat4), models.data(), usage);
+    for (int col = 0; col < 4; ++col) {
+        glVertexAttribPointer(3 + col, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (void*)(col * sizeof(glm::vec4)));
+        glEnableVertexAttribArray(3 + col);
+        glVertexAttribDivisor(3 + col, 1);
     }
+    inst.instanceCount = static_cast<GLsizei>(models.size());
+    inst.capacity = inst.instanceCount;
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
-// Atualiza toda a lógica do jogo a cada frame
-void updateGame(float deltaTime, GLFWwindow* window) {
-    if (gameState != PLAYING) return;
+// Desenha todas as instâncias numa chamada
+void drawInstancedMesh(const InstancedMesh& inst, const Mesh& mesh) {
+    if (inst.instanceCount == 0) return;
+    glBindVertexArray(inst.vao);
+    glDrawElementsInstanced(GL_TRIANGLES, mesh.indexCount, GL_UNSIGNED_INT, (void*)0, inst.instanceCount);
+    renderStats.vaoBinds++;
+    renderStats.draws++;
+}
 
-    gameTime += deltaTime;
-    spawnTimer += deltaTime;
+// Troca as instâncias de um buffer dinâmico (no máximo capacity), com orphaning
+void updateInstancedMesh(InstancedMesh& inst, const std::vector<glm::mat4>& models) {
+    inst.instanceCount = static_cast<GLsizei>(std::min(models.size(), static_cast<size_t>(inst.capacity)));
+    glBindBuffer(GL_ARRAY_BUFFER, inst.instanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, inst.capacity * sizeof(glm::mat4), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, inst.instanceCount * sizeof(glm::mat4), models.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
 
-    gameSpeed = 0.12f + (gameTime * 0.003f);  // Velocidade aumentada + progressão mais rápida
-    spawnInterval = glm::max(0.7f, 1.0f - (gameTime * 0.012f));
+void deleteInstancedMesh(InstancedMesh& inst) {
+    if (inst.vao == 0) return;
+    glDeleteVertexArrays(1, &inst.vao);
+    glDeleteBuffers(1, &inst.instanceVBO);
+    inst = InstancedMesh();
+}
 
-    if (spawnTimer >= spawnInterval) {
-        spawnTimer = 0.0f;
-        if (obstacles.size() < MAX_OBJECTS) spawnObject(0);
-        // Moedas agora são controladas pelo contador interno de aliens
-        if (collectibles.size() < 3) spawnObject(1); // Máximo de 3 moedas na tela
+// As árvores não se movem depois de initializeTrees(): as matrizes são calculadas uma vez. Cada passada
+// tem seu buffer de instâncias, preenchido só com as árvores que passam no culling dela (as cascatas de sombra
+// reaproveitam o mesmo buffer: updateInstancedMesh faz orphaning a cada envio)
+void setupTreeInstances(const Mesh& tree) {
+    treeModels.clear();
+    treeModels.reserve(treePositions.size());
+    for (size_t i = 0; i < treePositions.size(); ++i) {
+        glm::mat4 model = glm::translate(glm::mat4(1.0f), treePositions[i]);
+        model = glm::rotate(model, glm::radians(treeRotations[i]), glm::vec3(0.0f, 1.0f, 0.0f));
+        model = glm::scale(model, glm::vec3(treeScales[i]));
+        treeModels.push_back(model);
     }
+    visibleTreeModels.reserve(treeModels.size());
+    setupInstancedMesh(treeShadowInstances, tree, treeModels, GL_STREAM_DRAW);
+    setupInstancedMesh(treeCameraInstances, tree, treeModels, GL_STREAM_DRAW);
+}
 
-    for (auto& obs : obstacles) {
-        if (obs.active) {
-            obs.position.z += gameSpeed;
-			if (glm::length(obs.position - playerPos) < 0.6) {
-                createExplosion(obs.position);
-                gameState = GAME_OVER;
-                if (score > highScore) highScore = score;
-            }
-            if (obs.position.z > 8.0f) obs.active = false;
-        }
+// Compacta as árvores visíveis no frustum da passada e envia para o buffer de instâncias dela
+void cullTreeInstances(InstancedMesh& inst, const Mesh& tree, const Frustum& frustum, CullStats& stats) {
+    visibleTreeModels.clear();
+    for (const auto& model : treeModels) {
+        if (isVisible(frustum, tree.bounds, model, stats)) visibleTreeModels.push_back(model);
     }
+    updateInstancedMesh(inst, visibleTreeModels);
+}
 
-    for (auto& col : collectibles) {
-        if (col.active) {
-            col.position.z += gameSpeed;
-            col.position.y = 0.7f + sin(gameTime * 3.0f + col.position.x) * 0.2f;
-
-            if (glm::length(col.position - playerPos) < 1.2f) {
-                col.active = false;
-                score += 10;
-
-                for (int i = 0; i < 20; ++i) {
-                    CollectParticle p;
-                    p.position = col.position;
-                    float angle = (rand() % 360) * M_PI / 180.0f;
-                    float speed = 0.5f + (rand() % 100) / 100.0f;
-                    p.velocity = glm::vec3(cos(angle) * speed, 1.0f + (rand() % 100) / 50.0f, sin(angle) * speed);
-                    p.size = 0.05f + (rand() % 50) / 1000.0f;
-                    p.lifetime = 1.0f;
-                    collectParticles.push_back(p);
-                }
-            }
-            if (col.position.z > 8.0f) col.active = false;
-        }
-    }
+// Libera os buffers de uma malha
+void deleteMesh(Mesh& mesh) {
+    if (mesh.vao == 0) return;
+    glDeleteVertexArrays(1, &mesh.vao);
+    glDeleteBuffers(1, &mesh.vbo);
+    glDeleteBuffers(1, &mesh.ebo);
+    mesh = Mesh();
+}
 
-    obstacles.erase(std::remove_if(obstacles.begin(), obstacles.end(),
-        [](const GameObject& o) { return !o.active; }), obstacles.end());
-    collectibles.erase(std::remove_if(collectibles.begin(), collectibles.end(),
-        [](const GameObject& o) { return !o.active; }), collectibles.end());
-
-    // Thruster particles
-    for (auto& p : thrusterParticles) {
-        p.lifetime -= deltaTime * 2.0f;
-        p.offset.y += deltaTime * 0.5f;
-        p.size *= 0.98f;
-        p.intensity = p.lifetime;
-    }
-    thrusterParticles.erase(std::remove_if(thrusterParticles.begin(), thrusterParticles.end(),
-        [](const ThrusterParticle& p) { return p.lifetime <= 0.0f; }), thrusterParticles.end());
-
-    // Collect particles
-    for (auto& p : collectParticles) {
-        p.lifetime -= deltaTime * 2.0f;
-        p.position += p.velocity * deltaTime;
-        p.velocity.y -= 2.0f * deltaTime;
-        p.size *= 0.96f;
-    }
-    collectParticles.erase(std::remove_if(collectParticles.begin(), collectParticles.end(),
-        [](const CollectParticle& p) { return p.lifetime <= 0.0f; }), collectParticles.end());
-
-    // Speed particles (motion blur)
-    for (auto& p : speedParticles) {
-        p.lifetime -= deltaTime * 3.0f;
-        p.position += p.velocity * deltaTime;
-        p.size *= 0.95f;
-    }
-    speedParticles.erase(std::remove_if(speedParticles.begin(), speedParticles.end(),
-        [](const SpeedParticle& p) { return p.lifetime <= 0.0f; }), speedParticles.end());
-
-    // Explosion particles
-    for (auto& p : explosionParticles) {
-        p.lifetime -= deltaTime * 1.5f;
-        p.position += p.velocity * deltaTime;
-        p.velocity.y -= 5.0f * deltaTime;
-        p.size *= 0.94f;
-    }
-    explosionParticles.erase(std::remove_if(explosionParticles.begin(), explosionParticles.end(),
-        [](const ExplosionParticle& p) { return p.lifetime <= 0.0f; }), explosionParticles.end());
-
-    // Spawn thruster particles
-    static float particleSpawnTimer = 0.0f;
-    particleSpawnTimer += deltaTime;
-    if (particleSpawnTimer >= 0.03f) {
-        particleSpawnTimer = 0.0f;
-
-        glm::vec3 thrusterPositions[4] = {
-            glm::vec3(-0.3f, -0.5f, 0.0f),
-            glm::vec3(0.3f, -0.5f, 0.0f),
-            glm::vec3(-0.15f, -0.3f, -0.2f),
-            glm::vec3(0.15f, -0.3f, -0.2f)
-        };
+// ================ FILA DE RENDER ==================
+// Cada passada coleta DrawItems numa fila e a ordena por uma chave de 64 bits antes de enviar. Itens vizinhos com
+// o mesmo programa ou VAO não religam nada, então a ordem dos campos na chave decide quantas trocas sobram:
+//   estado primeiro:       passada (2 bits) | programa (8) | VAO (16) | profundidade (32)
+//   profundidade primeiro: passada (2 bits) | profundidade (32) | programa (8) | VAO (16)
+// A profundidade entra como o padrão de bits do float não negativo, que ordena igual ao valor
+enum RenderPass { PASS_SHADOW, PASS_DEPTH, PASS_OPAQUE };
+
+struct DrawItem {
+    uint64_t key;
+    const ShaderProgram* program;
+    GLuint vao;
+    GLsizei indexCount;
+    GLsizei instanceCount; // 0 = desenho simples; nos instanciados as matrizes vêm do buffer do VAO
+    glm::mat4 model;
+    glm::vec3 color;
+    float brightness;
+    bool textured;
+};
 
-        for (int i = 0; i < 4; ++i) {
-            ThrusterParticle p;
-            p.offset = thrusterPositions[i] + glm::vec3(
-                (rand() % 100 - 50) / 500.0f,
-                (rand() % 100 - 50) / 500.0f,
-                (rand() % 100 - 50) / 500.0f
-            );
-            p.size = 0.08f + (rand() % 100) / 1000.0f;
-            p.intensity = 1.0f;
-            p.lifetime = 1.0f;
-            thrusterParticles.push_back(p);
-        }
+uint64_t drawSortKey(RenderPass pass, const ShaderProgram& program, GLuint vao, float depth, bool depthFirst) {
+    float clamped = std::max(depth, 0.0f);
+    uint32_t depthBits;
+    std::memcpy(&depthBits, &clamped, sizeof(depthBits));
+    uint64_t state = (static_cast<uint64_t>(program.id & 0xFF) << 16) | (vao & 0xFFFF);
+    uint64_t key = static_cast<uint64_t>(pass) << 62;
+    if (depthFirst) return key | (static_cast<uint64_t>(depthBits) << 24) | state;
+    return key | (state << 32) | depthBits;
+}
+
+struct RenderQueue {
+    std::vector<DrawItem> items; // Reservado na inicialização; clear() mantém a capacidade
+
+    void clear() { items.clear(); }
+
+    // instances != nullptr desenha a malha instanciada (VAO e contagem do InstancedMesh)
+    void push(RenderPass pass, const ShaderProgram& program, const Mesh& mesh, const InstancedMesh* instances,
+              const glm::mat4& model, const glm::vec3& color, float brightness, bool textured, float depth, bool depthFirst) {
+        GLuint vao = instances ? instances->vao : mesh.vao;
+        items.push_back({ drawSortKey(pass, program, vao, depth, depthFirst), &program, vao, mesh.indexCount,
+                          instances ? instances->instanceCount : 0, model, color, brightness, textured });
     }
 
-    // Spawn speed particles (motion blur effect)
-    static float speedParticleTimer = 0.0f;
-    speedParticleTimer += deltaTime;
-    if (speedParticleTimer >= 0.05f && glm::length(playerVelocity) > 0.01f) {
-        speedParticleTimer = 0.0f;
-
-        for (int i = 0; i < 3; ++i) {
-            SpeedParticle p;
-            p.position = playerPos + glm::vec3(
-                randomFloat(-0.5f, 0.5f),
-                randomFloat(-0.3f, 0.3f),
-                randomFloat(-0.5f, 0.2f)
-            );
-            p.velocity = -playerVelocity * 5.0f;
-            p.size = randomFloat(0.03f, 0.08f);
-            p.lifetime = randomFloat(0.3f, 0.6f);
-            p.color = glm::vec3(0.6f, 0.8f, 1.0f);
-            speedParticles.push_back(p);
-        }
+    void sort() {
+        std::sort(items.begin(), items.end(), [](const DrawItem& a, const DrawItem& b) { return a.key < b.key; });
     }
 
-    // Spawn wind particles laterais
-    static float windParticleTimer = 0.0f;
-    windParticleTimer += deltaTime;
-    if (windParticleTimer >= 0.08f) {
-        windParticleTimer = 0.0f;
-
-        for (int i = 0; i < 2; ++i) {
-            SpeedParticle p;
-            float side = (rand() % 2 == 0) ? -10.0f : 10.0f;
-            p.position = glm::vec3(
-                side,
-                randomFloat(0.0f, 2.0f),
-                playerPos.z + randomFloat(-5.0f, 5.0f)
-            );
-            p.velocity = glm::vec3(-side * 0.3f, 0.0f, gameSpeed * 1.5f);
-            p.size = randomFloat(0.04f, 0.1f);
-            p.lifetime = randomFloat(1.0f, 2.0f);
-            p.color = glm::vec3(0.9f, 0.95f, 1.0f);
-            speedParticles.push_back(p);
+    // Envia os itens de uma passada, religando programa e VAO só quando mudam (bound = programa já em uso).
+    // Passadas de profundidade só precisam do model; a opaca leva também cor, brilho e textura
+    void submit(RenderPass pass, const ShaderProgram* bound = nullptr) const {
+        const ShaderProgram* currentProgram = bound;
+        GLuint currentVao = 0;
+        for (const DrawItem& item : items) {
+            if (static_cast<RenderPass>(item.key >> 62) != pass) continue;
+            if (item.program != currentProgram) {
+                item.program->use();
+                currentProgram = item.program;
+            }
+            if (item.vao != currentVao) {
+                glBindVertexArray(item.vao);
+                currentVao = item.vao;
+                renderStats.vaoBinds++;
+            }
+            if (pass == PASS_OPAQUE) setDrawUniforms(item.model, item.color, item.brightness, item.textured);
+            else setDrawUniforms(item.model);
+            if (item.instanceCount > 0) glDrawElementsInstanced(GL_TRIANGLES, item.indexCount, GL_UNSIGNED_INT, (void*)0, item.instanceCount);
+            else glDrawElements(GL_TRIANGLES, item.indexCount, GL_UNSIGNED_INT, (void*)0);
+            renderStats.draws++;
         }
     }
-}
+};
+RenderQueue shadowQueue, frameQueue;
 
-// Processo de input do teclado e atualização de estado do jogador/câmera
-void processInput(GLFWwindow* window) {
+// ================ INPUT ==================
+// Traduz o teclado para a entrada da simulação; ESC fecha a janela
+SimInput readInput(GLFWwindow* window) {
     if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
         glfwSetWindowShouldClose(window, true);
 
-    if (gameState == MENU) {
-        if (glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_PRESS ||
-            glfwGetKey(window, GLFW_KEY_ENTER) == GLFW_PRESS) {
-            gameState = PLAYING;
-            score = 0;
-            gameTime = 0.0f;
-            gameSpeed = 0.12f;
-            spawnInterval = 1.0f;
-            alienSpawnCount = 0;
-            playerPos = glm::vec3(0.0f, 0.5f, 0.0f);
-            playerVelocity = glm::vec3(0.0f);
-            playerRotation = 0.0f;
-            playerTilt = 0.0f;
-            runAnimationTime = 0.0f;
-            obstacles.clear();
-            collectibles.clear();
-            thrusterParticles.clear();
-            collectParticles.clear();
-            speedParticles.clear();
-            explosionParticles.clear();
-        }
-        return;
-    }
+    SimInput input;
+    input.left = glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS;
+    input.right = glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS;
+    input.forward = glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS;
+    input.back = glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS;
+    input.cameraLeft = glfwGetKey(window, GLFW_KEY_LEFT) == GLFW_PRESS;
+    input.cameraRight = glfwGetKey(window, GLFW_KEY_RIGHT) == GLFW_PRESS;
+    input.cameraUp = glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS;
+    input.cameraDown = glfwGetKey(window, GLFW_KEY_DOWN) == GLFW_PRESS;
+    bool space = glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_PRESS;
+    input.start = space || glfwGetKey(window, GLFW_KEY_ENTER) == GLFW_PRESS;
+    input.restart = space || glfwGetKey(window, GLFW_KEY_R) == GLFW_PRESS;
+    input.menu = glfwGetKey(window, GLFW_KEY_M) == GLFW_PRESS;
+    return input;
+}
 
-    if (gameState == GAME_OVER) {
-        if (glfwGetKey(window, GLFW_KEY_R) == GLFW_PRESS ||
-            glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_PRESS) {
-            gameState = PLAYING;
-            score = 0;
-            gameTime = 0.0f;
-            gameSpeed = 0.12f;
-            spawnInterval = 1.0f;
-            alienSpawnCount = 0;
-            playerPos = glm::vec3(0.0f, 0.5f, 0.0f);
-            playerVelocity = glm::vec3(0.0f);
-            playerRotation = 0.0f;
-            playerTilt = 0.0f;
-            runAnimationTime = 0.0f;
-            obstacles.clear();
-            collectibles.clear();
-            thrusterParticles.clear();
-            collectParticles.clear();
-            speedParticles.clear();
-            explosionParticles.clear();
+// ================ OPÇÕES DE LINHA DE COMANDO ==================
+// --stress <objetos> <particulas> <arvores> [segundos]: modo de estresse. Multiplica o limite de aliens, a
+//   emissão de partículas e as fileiras de árvores, começa a partida com o jogador invulnerável e sem vsync, e
+//   ao sair (ESC ou fim dos segundos) imprime os tempos de frame e de simulação
+// --gpu-particles: simula as partículas na GPU com transform feedback em vez da CPU
+// --depth-prepass: começa com o pré-passe de profundidade ligado (também há uma caixa na janela "Desempenho")
+// --seed <n>: semente da partida e do cenário (padrão: o relógio). A mesma semente repete os mesmos sorteios
+// --shadows <cascatas> <resolucao> [amostras]: quantidade de cascatas de sombra (1 a MAX_SHADOW_CASCADES), lado de
+//   cada mapa e amostras do PCF (1 a MAX_SHADOW_PCF_TAPS; 1 = uma só comparação bilinear)
+struct GameOptions {
+    bool stress = false;
+    float stressSeconds = 0.0f; // 0 = até fechar a janela
+    bool gpuParticles = false;
+    uint64_t seed = static_cast<uint64_t>(time(nullptr));
+};
+
+bool parseOptions(int argc, char** argv, GameOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--gpu-particles") == 0) {
+            options.gpuParticles = true;
+            continue;
         }
-        if (glfwGetKey(window, GLFW_KEY_M) == GLFW_PRESS) {
-            gameState = MENU;
-            score = 0;
-            gameTime = 0.0f;
-            gameSpeed = 0.12f;
-            spawnInterval = 1.0f;
-            alienSpawnCount = 0;
-            playerPos = glm::vec3(0.0f, 0.5f, 0.0f);
-            playerVelocity = glm::vec3(0.0f);
-            playerRotation = 0.0f;
-            playerTilt = 0.0f;
-            runAnimationTime = 0.0f;
-            obstacles.clear();
-            collectibles.clear();
-            thrusterParticles.clear();
-            collectParticles.clear();
-            speedParticles.clear();
-            explosionParticles.clear();
+        if (std::strcmp(argv[i], "--depth-prepass") == 0) {
+            depthPrepass = true;
+            continue;
+        }
+        if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            options.seed = std::strtoull(argv[++i], nullptr, 10);
+            continue;
+        }
+        if (std::strcmp(argv[i], "--shadows") == 0 && i + 2 < argc) {
+            shadowCascades = std::atoi(argv[i + 1]);
+            shadowCascadeSize = std::atoi(argv[i + 2]);
+            if (shadowCascades < 1 || shadowCascades > MAX_SHADOW_CASCADES || shadowCascadeSize < 128 || shadowCascadeSize > 8192) {
+                std::cerr << "Sombras invalidas: 1 a " << MAX_SHADOW_CASCADES << " cascatas de 128 a 8192 texels\n";
+                return false;
+            }
+            i += 2;
+            if (i + 1 < argc && argv[i + 1][0] != '-') {
+                shadowPcfTaps = std::atoi(argv[++i]);
+                if (shadowPcfTaps < 1 || shadowPcfTaps > MAX_SHADOW_PCF_TAPS) {
+                    std::cerr << "Amostras de sombra invalidas: 1 a " << MAX_SHADOW_PCF_TAPS << "\n";
+                    return false;
+                }
+            }
+            continue;
+        }
+        if (std::strcmp(argv[i], "--stress") != 0 || i + 3 >= argc) {
+            std::cerr << "Uso: " << argv[0] << " [--stress <objetos> <particulas> <arvores> [segundos]] [--gpu-particles] [--depth-prepass] [--seed <n>] [--shadows <cascatas> <resolucao> [amostras]]\n";
+            return false;
         }
-        return;
-    }
-
-	// Movimento do jogador
-    glm::vec3 moveDir(0.0f);
-    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS) moveDir.x -= 1.0f;
-    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS) moveDir.x += 1.0f;
-    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS) moveDir.z -= 1.0f;
-    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS) moveDir.z += 1.0f;
-
-	// Normaliza direção e aplica velocidade
-    if (glm::length(moveDir) > 0.0f) {
-        playerVelocity = glm::normalize(moveDir) * playerSpeed;
-        playerPos += playerVelocity;
-        playerPos.x = glm::clamp(playerPos.x, -8.0f, 8.0f);
-        playerPos.z = glm::clamp(playerPos.z, -3.0f, 5.0f);
 
-        float targetRotation = atan2(moveDir.x, moveDir.z) * 180.0f / M_PI;
-        playerRotation = glm::mix(playerRotation, targetRotation, 0.2f);
-        playerTilt = glm::clamp(moveDir.x * 15.0f, -20.0f, 20.0f);
-    }
-    else {
-        playerVelocity *= 0.8f;
-        playerTilt *= 0.9f;
+        float objects = static_cast<float>(std::atof(argv[i + 1]));
+        float particles = static_cast<float>(std::atof(argv[i + 2]));
+        float trees = static_cast<float>(std::atof(argv[i + 3]));
+        if (objects <= 0.0f || particles < 0.0f || trees < 0.0f) {
+            std::cerr << "Fatores de estresse invalidos\n";
+            return false;
+        }
+        i += 3;
+        if (i + 1 < argc && argv[i + 1][0] != '-') options.stressSeconds = static_cast<float>(std::atof(argv[++i]));
+
+        options.stress = true;
+        world.budget.objects = objects;
+        world.budget.particles = particles;
+        world.budget.invulnerable = true;
+        treeRows = scaledCount(NUM_TREE_ROWS, trees);
     }
-
-  
-    if (glfwGetKey(window, GLFW_KEY_LEFT) == GLFW_PRESS) cameraYaw -= cameraRotSpeed;
-    if (glfwGetKey(window, GLFW_KEY_RIGHT) == GLFW_PRESS) cameraYaw += cameraRotSpeed;
-    if (glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS) cameraPitch += cameraRotSpeed;
-    if (glfwGetKey(window, GLFW_KEY_DOWN) == GLFW_PRESS) cameraPitch -= cameraRotSpeed;
-
-    cameraPitch = glm::clamp(cameraPitch, -89.0f, 89.0f);
+    return true;
 }
 
 // ================ MAIN ==================
-int main() {
-    // Inicialização de random, GLFW, janela e contexto OpenGL
-    srand(static_cast<unsigned>(time(0)));
+int main(int argc, char** argv) {
+    GameOptions options;
+    if (!parseOptions(argc, argv, options)) return -1;
+
+    // Geradores da partida e do cenário, depois GLFW, janela e contexto OpenGL
+    world.rng.seed(options.seed);
+    sceneryRng.seed(options.seed + 1);
     if (!glfwInit()) {
         std::cerr << "Falha ao inicializar GLFW\n";
         return -1;
@@ -885,6 +1947,7 @@ int main() {
         return -1;
     }
     glfwMakeContextCurrent(window);
+    glfwSwapInterval(options.stress ? 0 : SWAP_INTERVAL);
     glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
     glfwSetKeyCallback(window, key_callback);
 
@@ -909,31 +1972,32 @@ int main() {
 
     // Inicializa árvores e buffers de vértices
     initializeTrees();
-    std::vector<float> playerVertices, cubeVertices, sphereVertices, groundVertices;
-    std::vector<float> alienVertices, bitcoinVertices;
-    std::vector<float> cloudVertices[5], treeVertices;
+    std::vector<float> cubeVertices, sphereVertices, groundVertices, quadVertices;
+    MeshData playerData, cubeData, sphereData, groundData, quadData;
+    MeshData alienData, bitcoinData, cloudData[5], treeData;
 
     // Carrega modelos ou usa formas básicas caso falhe
-    if (!loadOBJ(IRONMAN_MODEL, playerVertices)) {
+    if (!loadOBJ(IRONMAN_MODEL, playerData)) {
         std::cerr << "Modelo Iron Man nao encontrado, usando cubo\n";
+        std::vector<float> playerVertices;
         generateCube(playerVertices);
+        weldVertices(playerVertices, playerData);
     }
-    playerVertexCount = playerVertices.size() / 8;
 
-    if (loadOBJ(ALIEN_MODEL, alienVertices)) {
-        alienVertexCount = alienVertices.size() / 8;
+    if (loadOBJ(ALIEN_MODEL, alienData)) {
         alienModelLoaded = true;
-        std::cout << "✓ Modelo Alien carregado! Vertices: " << alienVertexCount << std::endl;
+        std::cout << "✓ Modelo Alien carregado! Vertices: " << alienData.vertexCount
+                  << " Indices: " << alienData.indexCount << std::endl;
     }
     else {
         std::cerr << "Aviso: Modelo Alien nao encontrado\n";
         alienModelLoaded = false;
     }
 
-    if (loadOBJ(BITCOIN_MODEL, bitcoinVertices)) {
-        bitcoinVertexCount = bitcoinVertices.size() / 8;
+    if (loadOBJ(BITCOIN_MODEL, bitcoinData)) {
         bitcoinModelLoaded = true;
-        std::cout << "✓ Modelo Bitcoin carregado! Vertices: " << bitcoinVertexCount << std::endl;
+        std::cout << "✓ Modelo Bitcoin carregado! Vertices: " << bitcoinData.vertexCount
+                  << " Indices: " << bitcoinData.indexCount << std::endl;
     }
     else {
         std::cerr << "Aviso: Modelo Bitcoin nao encontrado\n";
@@ -942,39 +2006,45 @@ int main() {
 
     // Gera formas básicas
     generateCube(cubeVertices);
-    cubeVertexCount = cubeVertices.size() / 8;
+    weldVertices(cubeVertices, cubeData);
     generateSphere(sphereVertices, 15);
-    sphereVertexCount = sphereVertices.size() / 8;
-    generateGround(groundVertices);
-
-    // Configura VAOs/VBOs
-    setupVAO(playerVAO, playerVBO, playerVertices);
-    setupVAO(cubeVAO, cubeVBO, cubeVertices);
-    setupVAO(sphereVAO, sphereVBO, sphereVertices);
-    setupVAO(groundVAO, groundVBO, groundVertices);
+    weldVertices(sphereVertices, sphereData);
+    generateGroundChunk(groundVertices, 2.0f * GROUND_SIZE * GROUND_QUAD_SIZE / GROUND_CHUNKS);
+    weldVertices(groundVertices, groundData);
+    generateQuad(quadVertices);
+    weldVertices(quadVertices, quadData);
+
+    // Configura VAOs/VBOs/EBOs
+    setupMesh(playerMesh, playerData);
+    setupMesh(cubeMesh, cubeData);
+    setupMesh(sphereMesh, sphereData);
+    setupMesh(groundMesh, groundData);
+    setupMesh(quadMesh, quadData);
+    setupParticleInstancing(quadMesh);
+    for (auto& system : gpuParticles) setupGpuParticleSystem(system, particlePoolCapacity(world.budget), quadMesh);
 
     if (alienModelLoaded) {
-        setupVAO(alienVAO, alienVBO, alienVertices);
+        setupMesh(alienMesh, alienData);
     }
     if (bitcoinModelLoaded) {
-        setupVAO(bitcoinVAO, bitcoinVBO, bitcoinVertices);
+        setupMesh(bitcoinMesh, bitcoinData);
     }
     for (int i = 0; i < 5; ++i) {
-        if (loadOBJ(CLOUD_MODELS[i], cloudVertices[i])) {
-            cloudVertexCount[i] = cloudVertices[i].size() / 8;
-            setupVAO(cloudVAO[i], cloudVBO[i], cloudVertices[i]);
+        if (loadOBJ(CLOUD_MODELS[i], cloudData[i])) {
+            setupMesh(cloudMesh[i], cloudData[i]);
         }
     }
-    if (loadOBJ(TREE_MODEL, treeVertices)) {
-        treeVertexCount = treeVertices.size() / 8;
-        setupVAO(treeVAO, treeVBO, treeVertices);
+    if (loadOBJ(TREE_MODEL, treeData)) {
+        setupMesh(treeMesh, treeData);
+        setupTreeInstances(treeMesh);
     }
 
     // --- SHADOW MAPPING ---
     // Shadow mapping é uma técnica para gerar sombras realistas. O processo envolve:
     // 1. Renderizar a cena a partir da perspectiva da luz (sol), gravando a profundidade de cada fragmento em um "depth map".
     // 2. No render principal, para cada fragmento, comparar sua profundidade com o valor do depth map para saber se está em sombra.
-    // O framebuffer e a textura de profundidade são configurados em setupShadowMapping().
+    // Com cascatas, o passo 1 se repete para cada fatia do frustum da câmera (fitShadowCascades) e o fragmento usa o
+    // depth map da fatia onde está. O framebuffer e a textura array de profundidade são configurados em setupShadowMapping().
     groundTexture = loadTexture(GROUND_TEXTURE.c_str());
     setupShadowMapping();
 
@@ -984,256 +2054,475 @@ int main() {
     // - mainVS/mainFS: usados para renderizar a cena principal, aplicando luz, sombra, textura e neblina.
     // O código compila, linka e valida cada shader, e depois os utiliza durante o render.
 
+	// Com INSTANCED definido, a matriz model vem do buffer de instâncias em vez do bloco DrawData
+	const char* instancedDefine = "#define INSTANCED\n";
 	const char* depthVS = R"( // Vertex shader para depth map
-#version 330 core
 layout(location = 0) in vec3 aPos;
-uniform mat4 lightSpaceMatrix;
-uniform mat4 model;
-void main() { gl_Position = lightSpaceMatrix * model * vec4(aPos, 1.0); }
+#ifdef INSTANCED
+layout(location = 3) in mat4 aInstanceModel;
+#define MODEL aInstanceModel
+#else
+#define MODEL model
+#endif
+uniform int cascade; // Camada do depth map sendo desenhada
+void main() { gl_Position = lightSpaceMatrices[cascade] * MODEL * vec4(aPos, 1.0); }
 )";
 	const char* depthFS = R"( // Fragment shader vazio, só precisamos da profundidade
-#version 330 core
 void main() {}
 )";
 
 	// Compila e linka shaders de depth map
-    GLuint depthVert = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(depthVert, 1, &depthVS, nullptr);
-    glCompileShader(depthVert);
-    checkShaderCompile(depthVert, "Depth VS");
-
-	// Fragment shader vazio
-    GLuint depthFrag = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(depthFrag, 1, &depthFS, nullptr);
-    glCompileShader(depthFrag);
-
-	// Linka programa de depth map
-    GLuint depthProgram = glCreateProgram();
-    glAttachShader(depthProgram, depthVert);
-    glAttachShader(depthProgram, depthFrag);
-    glLinkProgram(depthProgram);
-    checkProgramLink(depthProgram);
-    glDeleteShader(depthVert);
-    glDeleteShader(depthFrag);
+    ShaderProgram depthProgram;
+    depthProgram.init(linkProgram(
+        compileShader(GL_VERTEX_SHADER, { SHADER_VERSION, FRAME_DATA_GLSL, DRAW_DATA_GLSL, depthVS }, "Depth VS"),
+        compileShader(GL_FRAGMENT_SHADER, { SHADER_VERSION, depthFS }, "Depth FS")));
+    ShaderProgram depthInstancedProgram;
+    depthInstancedProgram.init(linkProgram(
+        compileShader(GL_VERTEX_SHADER, { SHADER_VERSION, instancedDefine, FRAME_DATA_GLSL, DRAW_DATA_GLSL, depthVS }, "Depth VS (instanced)"),
+        compileShader(GL_FRAGMENT_SHADER, { SHADER_VERSION, depthFS }, "Depth FS")));
 
 	const char* mainVS = R"( // Vertex shader principal
-#version 330 core
 layout(location = 0) in vec3 aPos;
 layout(location = 1) in vec3 aNormal;
 layout(location = 2) in vec2 aTexCoord;
+#ifdef INSTANCED
+layout(location = 3) in mat4 aInstanceModel;
+#define MODEL aInstanceModel
+#else
+#define MODEL model
+#endif
 
 // Váriaveis de saída para o fragment shader
 out vec3 FragPos;
 out vec3 Normal;
 out vec2 TexCoord;
-out vec4 FragPosLightSpace;
-
-// Matrizes uniformes (definidas no programa principal)
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
-uniform mat4 lightSpaceMatrix;
+out float ViewDepth; // Distância ao longo do eixo da câmera, escolhe a cascata de sombra
+invariant gl_Position; // O pré-passe usa este mesmo shader e o GL_EQUAL precisa da mesma profundidade
 
+// Matrizes vêm dos blocos FrameData (view, projection) e DrawData (model)
 // 
 void main() { 
-    FragPos = vec3(model * vec4(aPos, 1.0));
-    Normal = mat3(transpose(inverse(model))) * aNormal;
+    FragPos = vec3(MODEL * vec4(aPos, 1.0));
+    Normal = mat3(transpose(inverse(MODEL))) * aNormal;
     TexCoord = aTexCoord;
-    FragPosLightSpace = lightSpaceMatrix * vec4(FragPos, 1.0);
-    gl_Position = projection * view * model * vec4(aPos, 1.0);
+    vec4 viewPosition = view * vec4(FragPos, 1.0);
+    ViewDepth = -viewPosition.z;
+    gl_Position = projection * viewPosition;
 }
 )";
 	// Fragment shader principal
     const char* mainFS = R"(
-#version 330 core 
 // Váriaveis de entrada do vertex shader
 in vec3 FragPos;
 in vec3 Normal;
 in vec2 TexCoord;
-in vec4 FragPosLightSpace;
+in float ViewDepth;
 
 // Saída final da cor do fragmento
 out vec4 FragColor;
 
-// Texturas e variáveis uniformes
+// Texturas; o resto vem dos blocos FrameData e DrawData
 uniform sampler2D texture1;
-uniform sampler2D shadowMap;
-uniform vec3 lightPos;
-uniform vec3 viewPos;
-uniform vec3 objectColor;
-uniform int useTexture;
-uniform float brightness;
-
-// Função para calcular sombra usando shadow mapping com PCF (Percentage Closer Filtering)
-float ShadowCalculation(vec4 fragPosLightSpace) {
+uniform sampler2DArrayShadow shadowMap;
+
+// Disco de Poisson para o PCF; shadowParams.y diz quantas amostras usar
+const vec2 POISSON_DISK[16] = vec2[](
+    vec2(-0.942, -0.399), vec2(0.946, -0.769), vec2(-0.094, -0.929), vec2(0.345, 0.294),
+    vec2(-0.916, 0.458), vec2(-0.815, -0.879), vec2(-0.383, 0.277), vec2(0.975, 0.756),
+    vec2(0.443, -0.976), vec2(0.537, -0.474), vec2(-0.265, -0.419), vec2(0.792, 0.191),
+    vec2(-0.242, 0.997), vec2(-0.814, 0.914), vec2(0.200, 0.786), vec2(0.144, -0.141)
+);
+
+// Função para calcular sombra usando shadow mapping em cascata com PCF (Percentage Closer Filtering)
+float ShadowCalculation() {
+    // A primeira cascata cuja fatia contém o fragmento; depois da última não há sombra
+    int cascadeCount = int(shadowParams.x);
+    int cascade = 0;
+    while (cascade < cascadeCount && ViewDepth > cascadeSplits[cascade]) ++cascade;
+    if (cascade >= cascadeCount) return 0.0;
+
     // Realiza a transformação de coordenadas do espaço da luz para o espaço de textura
+    vec4 fragPosLightSpace = lightSpaceMatrices[cascade] * vec4(FragPos, 1.0);
     vec3 projCoords = fragPosLightSpace.xyz / fragPosLightSpace.w;
     projCoords = projCoords * 0.5 + 0.5;
     if(projCoords.z > 1.0) return 0.0;
     
-   
-    float closestDepth = texture(shadowMap, projCoords.xy).r;
     float currentDepth = projCoords.z;
     vec3 normal = normalize(Normal);
-    vec3 lightDir = normalize(lightPos - FragPos);
+    vec3 lightDir = normalize(lightPos.xyz - FragPos);
     float bias = max(0.05 * (1.0 - dot(normal, lightDir)), 0.005);
-    
-    float shadow = 0.0;
-    vec2 texelSize = 1.0 / textureSize(shadowMap, 0);
-    for(int x = -1; x <= 1; ++x) {
-        for(int y = -1; y <= 1; ++y) {
-            float pcfDepth = texture(shadowMap, projCoords.xy + vec2(x, y) * texelSize).r;
-            shadow += currentDepth - bias > pcfDepth ? 1.0 : 0.0;
-        }
+    float reference = currentDepth - bias;
+    float layer = float(cascade);
+
+    // Cada texture() já compara e filtra 2x2 texels no hardware
+    int taps = int(shadowParams.y);
+    if (taps <= 1) return 1.0 - texture(shadowMap, vec4(projCoords.xy, layer, reference));
+
+    // O disco gira por fragmento (ângulo de um hash da posição): o serrilhado vira um ruído fino
+    float angle = 6.2831853 * fract(sin(dot(FragPos.xz, vec2(12.9898, 78.233))) * 43758.5453);
+    mat2 rotation = mat2(cos(angle), sin(angle), -sin(angle), cos(angle));
+    vec2 radius = shadowParams.z / vec2(textureSize(shadowMap, 0).xy);
+    float lit = 0.0;
+    for (int i = 0; i < taps; ++i) {
+        lit += texture(shadowMap, vec4(projCoords.xy + rotation * POISSON_DISK[i] * radius, layer, reference));
     }
-    return shadow / 9.0;
+    return 1.0 - lit / float(taps);
 }
 
 
 void main() {
-    vec3 color = (useTexture == 1) ? texture(texture1, TexCoord).rgb : objectColor;
+    vec3 color = (drawParams.y > 0.5) ? texture(texture1, TexCoord).rgb : objectColor.rgb;
     vec3 normal = normalize(Normal);
-    vec3 lightDir = normalize(lightPos - FragPos);
+    vec3 lightDir = normalize(lightPos.xyz - FragPos);
     
     vec3 ambient = 0.4 * color;
     vec3 diffuse = max(dot(normal, lightDir), 0.0) * color;
     
-    vec3 viewDir = normalize(viewPos - FragPos);
+    vec3 viewDir = normalize(viewPos.xyz - FragPos);
     vec3 reflectDir = reflect(-lightDir, normal);
     vec3 specular = 0.6 * pow(max(dot(viewDir, reflectDir), 0.0), 32) * vec3(1.0);
     
-    float shadow = ShadowCalculation(FragPosLightSpace);
+    float shadow = ShadowCalculation();
     vec3 lighting = ambient + (1.0 - shadow) * (diffuse + specular);
     
     // FOG
-    float distance = length(viewPos - FragPos);
-    float fogStart = 20.0;
-    float fogEnd = 80.0;
-    float fogFactor = clamp((fogEnd - distance) / (fogEnd - fogStart), 0.0, 1.0);
-    vec3 fogColor = vec3(0.53, 0.81, 0.92);
+    float distance = length(viewPos.xyz - FragPos);
+    float fogFactor = clamp((fogParams.y - distance) / (fogParams.y - fogParams.x), 0.0, 1.0);
     
-    vec3 finalColor = mix(fogColor, lighting * brightness, fogFactor);
+    vec3 finalColor = mix(fogColor.rgb, lighting * drawParams.x, fogFactor);
     
     FragColor = vec4(finalColor, 1.0);
 }
 )";
 
 	// Compila e linka shaders principais
-    GLuint mainVert = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(mainVert, 1, &mainVS, nullptr);
-    glCompileShader(mainVert);
-    checkShaderCompile(mainVert, "Main VS");
-
-    GLuint mainFrag = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(mainFrag, 1, &mainFS, nullptr);
-    glCompileShader(mainFrag);
-    checkShaderCompile(mainFrag, "Main FS");
-
-	// Linka programa principal
-    GLuint mainProgram = glCreateProgram();
-    glAttachShader(mainProgram, mainVert);
-    glAttachShader(mainProgram, mainFrag);
-    glLinkProgram(mainProgram);
-    checkProgramLink(mainProgram);
-    glDeleteShader(mainVert);
-    glDeleteShader(mainFrag);
+    ShaderProgram mainProgram;
+    mainProgram.init(linkProgram(
+        compileShader(GL_VERTEX_SHADER, { SHADER_VERSION, FRAME_DATA_GLSL, DRAW_DATA_GLSL, mainVS }, "Main VS"),
+        compileShader(GL_FRAGMENT_SHADER, { SHADER_VERSION, FRAME_DATA_GLSL, DRAW_DATA_GLSL, mainFS }, "Main FS")));
+    ShaderProgram mainInstancedProgram;
+    mainInstancedProgram.init(linkProgram(
+        compileShader(GL_VERTEX_SHADER, { SHADER_VERSION, instancedDefine, FRAME_DATA_GLSL, DRAW_DATA_GLSL, mainVS }, "Main VS (instanced)"),
+        compileShader(GL_FRAGMENT_SHADER, { SHADER_VERSION, FRAME_DATA_GLSL, DRAW_DATA_GLSL, mainFS }, "Main FS")));
+
+	// Pré-passe de profundidade: o vertex shader principal com o fragment shader vazio do depth map
+    ShaderProgram prepassProgram;
+    prepassProgram.init(linkProgram(
+        compileShader(GL_VERTEX_SHADER, { SHADER_VERSION, FRAME_DATA_GLSL, DRAW_DATA_GLSL, mainVS }, "Prepass VS"),
+        compileShader(GL_FRAGMENT_SHADER, { SHADER_VERSION, depthFS }, "Depth FS")));
+    ShaderProgram prepassInstancedProgram;
+    prepassInstancedProgram.init(linkProgram(
+        compileShader(GL_VERTEX_SHADER, { SHADER_VERSION, instancedDefine, FRAME_DATA_GLSL, DRAW_DATA_GLSL, mainVS }, "Prepass VS (instanced)"),
+        compileShader(GL_FRAGMENT_SHADER, { SHADER_VERSION, depthFS }, "Depth FS")));
+
+	// Shaders das partículas: billboards instanciados virados para a câmera
+	const char* particleVS = R"( // Vertex shader de partículas
+layout(location = 0) in vec3 aPos;               // Canto do quad em [-1, 1]
+layout(location = 3) in vec3 aInstancePos;       // No espaço do model (o propulsor usa o do jogador)
+layout(location = 4) in vec3 aInstanceColor;
+layout(location = 5) in float aInstanceSize;
+layout(location = 6) in float aInstanceLifetime;
+
+out vec2 Corner;
+out vec3 Color;
+out float Brightness;
+out vec3 FragPos;
+
+void main() {
+    // Eixos direita/cima da câmera tirados das linhas da matriz de view
+    vec3 right = vec3(view[0][0], view[1][0], view[2][0]);
+    vec3 up = vec3(view[0][1], view[1][1], view[2][1]);
+    vec3 center = vec3(model * vec4(aInstancePos, 1.0));
+    FragPos = center + (right * aPos.x + up * aPos.y) * aInstanceSize;
+    Corner = aPos.xy;
+    Color = aInstanceColor;
+    Brightness = drawParams.x * aInstanceLifetime; // Brilho do sistema, apagando com a vida
+    gl_Position = projection * view * vec4(FragPos, 1.0);
+    // Slot morto do backend na GPU: joga o quad para fora do volume de recorte
+    if (aInstanceLifetime <= 0.0) gl_Position = vec4(0.0, 0.0, 2.0, 1.0);
+}
+)";
+	const char* particleFS = R"( // Fragment shader de partículas: disco com borda suave
+in vec2 Corner;
+in vec3 Color;
+in float Brightness;
+in vec3 FragPos;
+
+out vec4 FragColor;
+
+void main() {
+    float r2 = dot(Corner, Corner);
+    if (r2 > 1.0) discard;
+    // Partículas no fim da vida somem em vez de escurecer
+    float alpha = (1.0 - smoothstep(0.2, 1.0, r2)) * clamp(Brightness, 0.0, 1.0);
+
+    // Mesma neblina do shader principal
+    float distance = length(viewPos.xyz - FragPos);
+    float fogFactor = clamp((fogParams.y - distance) / (fogParams.y - fogParams.x), 0.0, 1.0);
+
+    FragColor = vec4(mix(fogColor.rgb, Color * Brightness, fogFactor), alpha);
+}
+)";
+
+	// Update das partículas na GPU: mesma ordem do ParticlePool::update (vida, posição, gravidade, tamanho)
+	const char* particleUpdateVS = R"( // Vertex shader de transform feedback das partículas
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec3 inVelocity;
+layout(location = 2) in vec3 inColor;
+layout(location = 3) in float inSize;
+layout(location = 4) in float inLifetime;
+
+out vec3 outPosition;
+out vec3 outVelocity;
+out vec3 outColor;
+out float outSize;
+out float outLifetime;
+
+uniform float deltaTime;
+uniform float decay;
+uniform float gravity;
+uniform float shrinkStep;
+uniform float pulse;     // 1 no propulsor
+uniform float gameTime;
+
+void main() {
+    outPosition = inPosition;
+    outVelocity = inVelocity;
+    outColor = inColor;
+    outSize = inSize;
+    outLifetime = inLifetime;
+    if (inLifetime <= 0.0) return; // Morta continua morta até o anel reaproveitar o slot
+
+    outLifetime = inLifetime - decay * deltaTime;
+    outPosition = inPosition + inVelocity * deltaTime;
+    outVelocity.y -= gravity * deltaTime;
+    outSize = inSize * shrinkStep;
+    if (pulse > 0.5) {
+        outColor = mix(vec3(0.2, 0.5, 1.0), vec3(0.8, 0.9, 1.0), sin(gameTime * 15.0 + outPosition.x * 10.0) * 0.5 + 0.5);
+    }
+}
+)";
+
+    ShaderProgram particleUpdateProgram;
+    particleUpdateProgram.init(linkTransformFeedbackProgram(
+        compileShader(GL_VERTEX_SHADER, { SHADER_VERSION, particleUpdateVS }, "Particle Update VS"),
+        { "outPosition", "outVelocity", "outColor", "outSize", "outLifetime" }));
+    GpuParticleUniforms particleUpdateUniforms = gpuParticleUniforms(particleUpdateProgram);
+
+    ShaderProgram particleProgram;
+    particleProgram.init(linkProgram(
+        compileShader(GL_VERTEX_SHADER, { SHADER_VERSION, FRAME_DATA_GLSL, DRAW_DATA_GLSL, particleVS }, "Particle VS"),
+        compileShader(GL_FRAGMENT_SHADER, { SHADER_VERSION, FRAME_DATA_GLSL, particleFS }, "Particle FS")));
+
+	// Liga os blocos compartilhados e fixa as unidades de textura
+    setupUniformBuffers();
+    ShaderProgram* programs[] = { &depthProgram, &depthInstancedProgram, &mainProgram, &mainInstancedProgram,
+                                  &prepassProgram, &prepassInstancedProgram, &particleProgram };
+    for (ShaderProgram* program : programs) {
+        program->bindBlock("FrameData", FRAME_UBO_BINDING);
+        program->bindBlock("DrawData", DRAW_UBO_BINDING);
+    }
+    for (ShaderProgram* program : { &mainProgram, &mainInstancedProgram }) {
+        program->use();
+        program->setInt(program->uniform("texture1"), 0);
+        program->setInt(program->uniform("shadowMap"), 1);
+    }
+    int depthCascadeUniform = depthProgram.uniform("cascade");
+    int depthInstancedCascadeUniform = depthInstancedProgram.uniform("cascade");
 
     float lastTime = glfwGetTime();
+    float simAccumulator = 0.0f;
+    bool gpuParticlesEnabled = options.gpuParticles;
+    resetRun(world, options.stress ? PLAYING : MENU); // Reserva objetos e partículas antes do loop
+    // Filas de render: casters dinâmicos de uma cascata; opacos do frame, duas vezes por causa do pré-passe
+    shadowQueue.items.reserve(1 + obstacleCapacity(world.budget) + MAX_COLLECTIBLES);
+    frameQueue.items.reserve(2 * (GROUND_CHUNKS * GROUND_CHUNKS + NUM_CLOUDS + obstacleCapacity(world.budget) + MAX_COLLECTIBLES + 3));
+    glGenQueries(FRAGMENT_QUERIES, shadedFragments.queries);
+    setExternalParticles(world, gpuParticlesEnabled);
+    if (options.stress) {
+        std::cout << "Modo de estresse: objetos x" << world.budget.objects << ", particulas x" << world.budget.particles
+                  << ", " << treeRows << " fileiras de arvores, semente " << options.seed << "\n";
+    }
+    float stressStart = lastTime;
 
     // ================== LOOP PRINCIPAL DO JOGO ==================
+#ifndef NDEBUG
+    long frameIndex = 0;
+#endif
     while (!glfwWindowShouldClose(window)) {
+#ifndef NDEBUG
+        unsigned long allocationsBefore = heapAllocations.load(std::memory_order_relaxed);
+#endif
         float currentTime = glfwGetTime();
         float deltaTime = currentTime - lastTime;
         lastTime = currentTime;
-
-        // Processa input e atualiza logica do jogo
-        processInput(window);
-        updateGame(deltaTime, window);
-
-        // Atualiza animação do personagem
-        if (gameState == PLAYING) {
-            runAnimationTime += deltaTime * 10.0f;
+        if (options.stress && options.stressSeconds > 0.0f && currentTime - stressStart >= options.stressSeconds)
+            glfwSetWindowShouldClose(window, true);
+
+        // Processa input e atualiza logica do jogo em passos fixos de SIM_DT
+        double simBegin = glfwGetTime();
+        simAccumulator += std::min(deltaTime, MAX_SIM_STEPS * SIM_DT);
+        while (simAccumulator >= SIM_DT) {
+            stepSimulation(world, readInput(window), SIM_DT);
+            if (gpuParticlesEnabled && world.gameState == PLAYING)
+                stepGpuParticles(particleUpdateProgram, particleUpdateUniforms, world, SIM_DT);
+            simAccumulator -= SIM_DT;
         }
+        frameStats.add(deltaTime * 1000.0f, static_cast<float>((glfwGetTime() - simBegin) * 1000.0));
+
+		// Fração do próximo passo já decorrida: o render mostra o estado entre os dois últimos passos
+        float alpha = simAccumulator / SIM_DT;
+        glm::vec3 renderPlayerPos = glm::mix(world.prevPlayerPos, world.playerPos, alpha);
 
 		// Inclina o personagem para frente ao voar
         float flyTilt = 60.0f;
-        if (glm::length(playerVelocity) > 0.01f) {
-            flyTilt = 70.0f + sin(runAnimationTime) * 5.0f;
+        if (playerMoving(world)) {
+            flyTilt = 70.0f + sin(world.runAnimationTime) * 5.0f;
         }
 
-        // Calcula transformações de câmera e luz
+        // Calcula transformações de câmera e luz (as cascatas de sombra dependem da câmera, ver abaixo)
         glm::vec3 lightPos = sunPos;
-        float near_plane = 1.0f, far_plane = 60.0f;
-        glm::mat4 lightProjection = glm::ortho(-25.0f, 25.0f, -25.0f, 25.0f, near_plane, far_plane);
-        glm::mat4 lightView = glm::lookAt(lightPos, glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
-        glm::mat4 lightSpaceMatrix = lightProjection * lightView;
-
-		// Renderiza mapa de profundidade (shadow map)
-        glUseProgram(depthProgram);
-        glUniformMatrix4fv(glGetUniformLocation(depthProgram, "lightSpaceMatrix"), 1, GL_FALSE, &lightSpaceMatrix[0][0]);
-
-        glViewport(0, 0, SHADOW_SIZE, SHADOW_SIZE);
-        glBindFramebuffer(GL_FRAMEBUFFER, depthMapFBO);
-        glClear(GL_DEPTH_BUFFER_BIT);
-
-		// Função lambda para renderizar objetos no mapa de profundidade
-        auto renderDepth = [&](const glm::mat4& model, GLuint vao, int count) {
-            glUniformMatrix4fv(glGetUniformLocation(depthProgram, "model"), 1, GL_FALSE, &model[0][0]);
-            glBindVertexArray(vao);
-            glDrawArrays(GL_TRIANGLES, 0, count);
-            };
 
-		// Renderiza chão, jogador, obstáculos e árvores
-        if (gameState == PLAYING) {
-            renderDepth(glm::mat4(1.0f), groundVAO, groundVertices.size() / 8);
+        glm::vec3 cameraPos;
+        glm::mat4 view;
+
+		// Atualiza posição da câmera
+        if (world.gameState == PLAYING) {
+            float yawRad = glm::radians(world.cameraYaw);
+            float pitchRad = glm::radians(world.cameraPitch);
+            glm::vec3 cameraDir(cos(yawRad) * cos(pitchRad), sin(pitchRad), sin(yawRad) * cos(pitchRad));
+            cameraDir = glm::normalize(cameraDir);
 
-            glm::mat4 playerModel = glm::translate(glm::mat4(1.0f), playerPos);
-            float bobAmount = sin(runAnimationTime) * 0.05f;
-            if (glm::length(playerVelocity) > 0.01f) {
+            cameraPos = renderPlayerPos - cameraDir * cameraDistance + glm::vec3(0.0f, cameraHeight, 0.0f);
+			// Evita que a câmera fique abaixo do chão
+            if (cameraPos.y < 2.0f) {
+                cameraPos = renderPlayerPos - cameraDir * 3.0f + glm::vec3(0.0f, cameraHeight, 0.0f);
+                if (cameraPos.y < 0.5f) cameraPos.y = 0.5f;
+                view = glm::lookAt(cameraPos, renderPlayerPos + glm::vec3(0.0f, 5.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+            }
+            
+            else {
+                view = glm::lookAt(cameraPos, renderPlayerPos, glm::vec3(0.0f, 1.0f, 0.0f));
+            }
+        }
+        else {
+            cameraPos = glm::vec3(0.0f, 5.0f, 10.0f);
+            view = glm::lookAt(cameraPos, glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        }
+
+        float aspectRatio = (float)currentWidth / (float)currentHeight;
+        if (aspectRatio <= 0.0f) aspectRatio = 1.0f;
+        glm::mat4 projection = glm::perspective(glm::radians(FOV_DEGREES), aspectRatio, CAMERA_NEAR, CAMERA_FAR);
+
+        ShadowCascade cascades[MAX_SHADOW_CASCADES];
+        fitShadowCascades(view, aspectRatio, lightPos, cascades);
+
+		// Dados do frame: um único upload compartilhado pelos programas de profundidade, principal e partículas
+        FrameUniforms frameUniforms;
+        frameUniforms.view = view;
+        frameUniforms.projection = projection;
+        for (int c = 0; c < shadowCascades; ++c) {
+            frameUniforms.lightSpaceMatrices[c] = cascades[c].lightSpace;
+            frameUniforms.cascadeSplits[c] = cascades[c].splitFar;
+        }
+        frameUniforms.shadowParams = glm::vec4(static_cast<float>(shadowCascades), static_cast<float>(shadowPcfTaps), SHADOW_PCF_RADIUS, 0.0f);
+        frameUniforms.lightPos = glm::vec4(lightPos, 1.0f);
+        frameUniforms.viewPos = glm::vec4(cameraPos, 1.0f);
+        frameUniforms.fogParams = glm::vec4(FOG_START, FOG_END, 0.0f, 0.0f);
+        frameUniforms.fogColor = glm::vec4(FOG_COLOR, 1.0f);
+        uploadFrameUniforms(frameUniforms);
+
+		// Frustums de culling: câmera (passada principal) e, na passada de sombra, a caixa ortográfica de cada cascata
+        Frustum cameraFrustum;
+        cameraFrustum.extract(projection * view);
+        cameraCull = CullStats();
+        shadowCull = CullStats();
+        renderStats = RenderStats();
+
+		// Renderiza o mapa de profundidade de cada cascata na sua camada: árvores vêm do cache, o resto é desenhado por cima
+        glViewport(0, 0, shadowCascadeSize, shadowCascadeSize);
+        staticShadows.rebuilds = 0;
+        for (int cascade = 0; cascade < shadowCascades; ++cascade) {
+            Frustum lightFrustum;
+            lightFrustum.extract(cascades[cascade].lightSpace);
+
+			// Refaz a camada estática só se a caixa da cascata mudou desde que ela foi desenhada
+            glBindFramebuffer(GL_FRAMEBUFFER, staticShadows.fbo);
+            glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, staticShadows.depthMap, 0, cascade);
+            if (!staticShadows.valid[cascade] || staticShadows.lightSpace[cascade] != cascades[cascade].lightSpace) {
+                glClear(GL_DEPTH_BUFFER_BIT);
+                if (treeMesh.indexCount > 0) {
+                    depthInstancedProgram.use();
+                    depthInstancedProgram.setInt(depthInstancedCascadeUniform, cascade);
+                    cullTreeInstances(treeShadowInstances, treeMesh, lightFrustum, shadowCull);
+                    drawInstancedMesh(treeShadowInstances, treeMesh);
+                }
+                staticShadows.lightSpace[cascade] = cascades[cascade].lightSpace;
+                staticShadows.valid[cascade] = true;
+                staticShadows.rebuilds++;
+            }
+
+            glBindFramebuffer(GL_FRAMEBUFFER, depthMapFBO);
+            glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, depthMap, 0, cascade);
+            if (world.gameState != PLAYING) {
+                glClear(GL_DEPTH_BUFFER_BIT);
+                continue;
+            }
+
+			// Copia as árvores e desenha jogador, obstáculos e moedas por cima (o chão só recebe sombra)
+            glBindFramebuffer(GL_READ_FRAMEBUFFER, staticShadows.fbo);
+            glBlitFramebuffer(0, 0, shadowCascadeSize, shadowCascadeSize, 0, 0, shadowCascadeSize, shadowCascadeSize,
+                GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+            glBindFramebuffer(GL_FRAMEBUFFER, depthMapFBO);
+            depthProgram.use();
+            depthProgram.setInt(depthCascadeUniform, cascade);
+
+			// Função lambda para enfileirar objetos no mapa de profundidade (agrupados por malha ao enviar)
+            shadowQueue.clear();
+            auto renderDepth = [&](const glm::mat4& model, const Mesh& mesh) {
+                if (!isVisible(lightFrustum, mesh.bounds, model, shadowCull)) return;
+                shadowQueue.push(PASS_SHADOW, depthProgram, mesh, nullptr, model, glm::vec3(1.0f), 1.0f, false, 0.0f, false);
+                };
+
+            glm::mat4 playerModel = glm::translate(glm::mat4(1.0f), renderPlayerPos);
+            float bobAmount = sin(world.runAnimationTime) * 0.05f;
+            if (playerMoving(world)) {
                 playerModel = glm::translate(playerModel, glm::vec3(0.0f, bobAmount, 0.0f));
             }
-            playerModel = glm::rotate(playerModel, glm::radians(playerRotation), glm::vec3(0.0f, 1.0f, 0.0f));
-            playerModel = glm::rotate(playerModel, glm::radians(playerTilt), glm::vec3(0.0f, 0.0f, 1.0f));
+            playerModel = glm::rotate(playerModel, glm::radians(world.playerRotation), glm::vec3(0.0f, 1.0f, 0.0f));
+            playerModel = glm::rotate(playerModel, glm::radians(world.playerTilt), glm::vec3(0.0f, 0.0f, 1.0f));
             playerModel = glm::scale(playerModel, glm::vec3(IRONMAN_SCALE));
-            renderDepth(playerModel, playerVAO, playerVertexCount);
+            renderDepth(playerModel, playerMesh);
 
 			// Renderiza obstáculos
-            for (const auto& obs : obstacles) {
+            for (const auto& obs : world.obstacles) {
                 if (obs.active) {
 					// Renderiza alien ou cubo dependendo se o modelo foi carregado
-                    glm::mat4 m = glm::translate(glm::mat4(1.0f), obs.position);
+                    glm::mat4 m = glm::translate(glm::mat4(1.0f), interpolatedPosition(obs, alpha));
                     m = glm::rotate(m, glm::radians(obs.rotation), glm::vec3(0.0f, 1.0f, 0.0f));
                     if (alienModelLoaded) {
                         m = glm::scale(m, obs.scale * ALIEN_SCALE);
-                        renderDepth(m, alienVAO, alienVertexCount);
+                        renderDepth(m, alienMesh);
                     }
                     else {
                         m = glm::scale(m, obs.scale * 0.15f);
-                        renderDepth(m, cubeVAO, cubeVertexCount);
+                        renderDepth(m, cubeMesh);
                     }
                 }
             }
 
 			// Renderiza moedas
-            for (const auto& col : collectibles) {
+            for (const auto& col : world.collectibles) {
                 if (col.active) {
-                    glm::mat4 m = glm::translate(glm::mat4(1.0f), col.position);
+                    glm::mat4 m = glm::translate(glm::mat4(1.0f), interpolatedPosition(col, alpha));
                     if (bitcoinModelLoaded) {
                         m = glm::scale(m, glm::vec3(BITCOIN_SCALE));
-                        renderDepth(m, bitcoinVAO, bitcoinVertexCount);
+                        renderDepth(m, bitcoinMesh);
                     }
                 }
             }
-
-			// Renderiza árvores
-            if (treeVertexCount > 0) {
-                for (size_t i = 0; i < treePositions.size(); ++i) {
-                    glm::mat4 model = glm::translate(glm::mat4(1.0f), treePositions[i]);
-                    model = glm::rotate(model, glm::radians(treeRotations[i]), glm::vec3(0.0f, 1.0f, 0.0f));
-                    model = glm::scale(model, glm::vec3(treeScales[i]));
-                    renderDepth(model, treeVAO, treeVertexCount);
-                }
-            }
+            shadowQueue.sort();
+            shadowQueue.submit(PASS_SHADOW, &depthProgram);
         }
 
 		// Renderiza partículas no mapa de profundidade
@@ -1242,232 +2531,181 @@ void main() {
         glViewport(0, 0, currentWidth, currentHeight);
 
         // CÉU GRADIENTE DINÂMICO
-        float skyTopR = 0.3f + sin(gameTime * 0.1f) * 0.1f;
-        float skyTopG = 0.6f + cos(gameTime * 0.15f) * 0.15f;
+        float skyTopR = 0.3f + sin(world.gameTime * 0.1f) * 0.1f;
+        float skyTopG = 0.6f + cos(world.gameTime * 0.15f) * 0.15f;
         float skyTopB = 0.9f;
         glClearColor(skyTopR, skyTopG, skyTopB, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        glm::vec3 cameraPos;
-        glm::mat4 view;
-
-		// Atualiza posição da câmera
-        if (gameState == PLAYING) {
-            float yawRad = glm::radians(cameraYaw);
-            float pitchRad = glm::radians(cameraPitch);
-            glm::vec3 cameraDir(cos(yawRad) * cos(pitchRad), sin(pitchRad), sin(yawRad) * cos(pitchRad));
-            cameraDir = glm::normalize(cameraDir);
-
-            cameraPos = playerPos - cameraDir * cameraDistance + glm::vec3(0.0f, cameraHeight, 0.0f);
-			// Evita que a câmera fique abaixo do chão
-            if (cameraPos.y < 2.0f) {
-                cameraPos = playerPos - cameraDir * 3.0f + glm::vec3(0.0f, cameraHeight, 0.0f);
-                if (cameraPos.y < 0.5f) cameraPos.y = 0.5f;
-                view = glm::lookAt(cameraPos, playerPos + glm::vec3(0.0f, 5.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
-            }
-            
-            else {
-                view = glm::lookAt(cameraPos, playerPos, glm::vec3(0.0f, 1.0f, 0.0f));
-            }
-        }
-        else {
-            cameraPos = glm::vec3(0.0f, 5.0f, 10.0f);
-            view = glm::lookAt(cameraPos, glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
-        }
-
-        float aspectRatio = (float)currentWidth / (float)currentHeight;
-        if (aspectRatio <= 0.0f) aspectRatio = 1.0f;
-        glm::mat4 projection = glm::perspective(glm::radians(FOV_DEGREES), aspectRatio, 0.1f, 100.0f);
-
-        glUseProgram(mainProgram);
-        glUniform3fv(glGetUniformLocation(mainProgram, "lightPos"), 1, &lightPos[0]);
-        glUniform3fv(glGetUniformLocation(mainProgram, "viewPos"), 1, &cameraPos[0]);
-        glUniformMatrix4fv(glGetUniformLocation(mainProgram, "view"), 1, GL_FALSE, &view[0][0]);
-        glUniformMatrix4fv(glGetUniformLocation(mainProgram, "projection"), 1, GL_FALSE, &projection[0][0]);
-        glUniformMatrix4fv(glGetUniformLocation(mainProgram, "lightSpaceMatrix"), 1, GL_FALSE, &lightSpaceMatrix[0][0]);
-
         glActiveTexture(GL_TEXTURE1);
-        glBindTexture(GL_TEXTURE_2D, depthMap);
-        glUniform1i(glGetUniformLocation(mainProgram, "shadowMap"), 1);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, depthMap);
 
         glActiveTexture(GL_TEXTURE0);
         glBindTexture(GL_TEXTURE_2D, groundTexture);
-        glUniform1i(glGetUniformLocation(mainProgram, "texture1"), 0);
-        glUniform1i(glGetUniformLocation(mainProgram, "useTexture"), 1);
-        glUniform1f(glGetUniformLocation(mainProgram, "brightness"), 1.0f);
 
-        glUniformMatrix4fv(glGetUniformLocation(mainProgram, "model"), 1, GL_FALSE, &glm::mat4(1.0f)[0][0]);
-        glBindVertexArray(groundVAO);
-        glDrawArrays(GL_TRIANGLES, 0, groundVertices.size() / 8);
+		// Coleta os opacos na fila do frame (e no pré-passe, se ligado). Com pré-passe, o GL_EQUAL já sombreia cada
+		// pixel uma vez e a fila agrupa por estado; sem ele, a ordem da frente para trás vem antes do estado.
+		// Sem ordenação, a "profundidade" é a ordem de chegada e a fila mantém a ordem do código
+        frameQueue.clear();
+        auto queueOpaqueItem = [&](const ShaderProgram& program, const ShaderProgram& prepass, const Mesh& mesh,
+                                   const InstancedMesh* instances, const glm::mat4& model, const glm::vec3& color,
+                                   float brightness, bool textured, float depth) {
+            if (!sortOpaque) depth = static_cast<float>(frameQueue.items.size());
+            frameQueue.push(PASS_OPAQUE, program, mesh, instances, model, color, brightness, textured, depth, !depthPrepass || !sortOpaque);
+            if (depthPrepass) frameQueue.push(PASS_DEPTH, prepass, mesh, instances, model, color, brightness, textured, depth, false);
+            };
+		// Malhas comuns que tocam o frustum da câmera; a profundidade no espaço da câmera é a do centro da esfera envolvente
+        auto queueOpaque = [&](const glm::mat4& model, const Mesh& mesh, const glm::vec3& color, float brightness) {
+            if (!isVisible(cameraFrustum, mesh.bounds, model, cameraCull)) return;
+            float depth = -(view * model * glm::vec4(mesh.bounds.center, 1.0f)).z;
+            queueOpaqueItem(mainProgram, prepassProgram, mesh, nullptr, model, color, brightness, false, depth);
+            };
 
-        glUniform1i(glGetUniformLocation(mainProgram, "useTexture"), 0);
+		// Chão em chunks: só os que tocam o frustum da câmera são desenhados. Ele só recebe sombra,
+		// por isso não entra na passada de sombra
+        const float chunkSize = 2.0f * GROUND_SIZE * GROUND_QUAD_SIZE / GROUND_CHUNKS;
+        const float groundHalf = GROUND_SIZE * GROUND_QUAD_SIZE;
+        for (int cx = 0; cx < GROUND_CHUNKS; ++cx) {
+            for (int cz = 0; cz < GROUND_CHUNKS; ++cz) {
+                glm::vec3 chunkMin(-groundHalf + cx * chunkSize, 0.0f, -groundHalf + cz * chunkSize);
+                glm::vec3 chunkMax = chunkMin + glm::vec3(chunkSize, 0.0f, chunkSize);
+                bool chunkVisible = cameraFrustum.intersectsAABB(chunkMin, chunkMax);
+                (chunkVisible ? cameraCull.visible : cameraCull.culled)++;
+                if (!chunkVisible) continue;
+                glm::vec3 chunkCenter = (chunkMin + chunkMax) * 0.5f;
+                float depth = -(view * glm::vec4(chunkCenter, 1.0f)).z;
+                queueOpaqueItem(mainProgram, prepassProgram, groundMesh, nullptr, glm::translate(glm::mat4(1.0f), chunkCenter),
+                                glm::vec3(1.0f), 1.0f, true, depth);
+            }
+        }
 
 		// Renderiza nuvens
         for (int i = 0; i < NUM_CLOUDS; ++i) {
-            if (cloudVertexCount[i % 5] > 0) {
-                glUniform3f(glGetUniformLocation(mainProgram, "objectColor"), 0.95f, 0.95f, 1.0f);
-                glUniform1f(glGetUniformLocation(mainProgram, "brightness"), 2.0f);
+            if (cloudMesh[i % 5].indexCount > 0) {
                 glm::mat4 model = glm::scale(glm::translate(glm::mat4(1.0f), cloudPos[i]), glm::vec3(cloudScale[i]));
-                glUniformMatrix4fv(glGetUniformLocation(mainProgram, "model"), 1, GL_FALSE, &model[0][0]);
-                glBindVertexArray(cloudVAO[i % 5]);
-                glDrawArrays(GL_TRIANGLES, 0, cloudVertexCount[i % 5]);
+                queueOpaque(model, cloudMesh[i % 5], glm::vec3(0.95f, 0.95f, 1.0f), 2.0f);
             }
         }
 
-
-        if (treeVertexCount > 0) {
-            glUniform3f(glGetUniformLocation(mainProgram, "objectColor"), 0.6f, 0.5f, 0.3f);
-            glUniform1f(glGetUniformLocation(mainProgram, "brightness"), 1.2f);
-            for (size_t i = 0; i < treePositions.size(); ++i) {
-                glm::mat4 model = glm::translate(glm::mat4(1.0f), treePositions[i]);
-                model = glm::rotate(model, glm::radians(treeRotations[i]), glm::vec3(0.0f, 1.0f, 0.0f));
-                model = glm::scale(model, glm::vec3(treeScales[i]));
-                glUniformMatrix4fv(glGetUniformLocation(mainProgram, "model"), 1, GL_FALSE, &model[0][0]);
-                glBindVertexArray(treeVAO);
-                glDrawArrays(GL_TRIANGLES, 0, treeVertexCount);
+		// Árvores instanciadas: um único desenho, ordenado pela árvore visível mais próxima. Cor e brilho vêm
+		// do DrawData, as matrizes do buffer de instâncias
+        if (treeMesh.indexCount > 0) {
+            cullTreeInstances(treeCameraInstances, treeMesh, cameraFrustum, cameraCull);
+            float nearestTree = CAMERA_FAR;
+            for (const glm::mat4& model : visibleTreeModels) {
+                nearestTree = std::min(nearestTree, -(view * model * glm::vec4(treeMesh.bounds.center, 1.0f)).z);
+            }
+            if (treeCameraInstances.instanceCount > 0) {
+                queueOpaqueItem(mainInstancedProgram, prepassInstancedProgram, treeMesh, &treeCameraInstances, glm::mat4(1.0f),
+                                glm::vec3(0.6f, 0.5f, 0.3f), 1.2f, false, nearestTree);
             }
         }
 
-        if (gameState == PLAYING) {
-            glUniform3f(glGetUniformLocation(mainProgram, "objectColor"), 0.8f, 0.1f, 0.1f);
-            glUniform1f(glGetUniformLocation(mainProgram, "brightness"), 1.2f);
-
-            glm::mat4 playerModel = glm::translate(glm::mat4(1.0f), playerPos);
-            playerModel = glm::rotate(playerModel, glm::radians(playerRotation), glm::vec3(0.0f, 1.0f, 0.0f));
+        if (world.gameState == PLAYING) {
+            glm::mat4 playerModel = glm::translate(glm::mat4(1.0f), renderPlayerPos);
+            playerModel = glm::rotate(playerModel, glm::radians(world.playerRotation), glm::vec3(0.0f, 1.0f, 0.0f));
             playerModel = glm::rotate(playerModel, glm::radians(flyTilt), glm::vec3(1.0f, 0.0f, 0.0f));
-            playerModel = glm::rotate(playerModel, glm::radians(playerTilt), glm::vec3(0.0f, 0.0f, 1.0f));
+            playerModel = glm::rotate(playerModel, glm::radians(world.playerTilt), glm::vec3(0.0f, 0.0f, 1.0f));
             playerModel = glm::scale(playerModel, glm::vec3(IRONMAN_SCALE));
 
-            glUniformMatrix4fv(glGetUniformLocation(mainProgram, "model"), 1, GL_FALSE, &playerModel[0][0]);
-            glBindVertexArray(playerVAO);
-            glDrawArrays(GL_TRIANGLES, 0, playerVertexCount);
-
-			// Particulas do thruster (propulsor)
-            for (const auto& particle : thrusterParticles) {
-                glm::vec3 color = glm::mix(
-                    glm::vec3(0.2f, 0.5f, 1.0f),
-                    glm::vec3(0.8f, 0.9f, 1.0f),
-                    sin(gameTime * 15.0f + particle.offset.x * 10.0f) * 0.5f + 0.5f
-                );
-                glUniform3fv(glGetUniformLocation(mainProgram, "objectColor"), 1, &color[0]);
-                glUniform1f(glGetUniformLocation(mainProgram, "brightness"), 2.5f * particle.intensity);
-
-                glm::mat4 particleModel = glm::translate(glm::mat4(1.0f), playerPos);
-                particleModel = glm::rotate(particleModel, glm::radians(playerRotation), glm::vec3(0.0f, 1.0f, 0.0f));
-                particleModel = glm::rotate(particleModel, glm::radians(flyTilt), glm::vec3(1.0f, 0.0f, 0.0f));
-                particleModel = glm::translate(particleModel, particle.offset);
-                particleModel = glm::scale(particleModel, glm::vec3(particle.size));
-
-                glUniformMatrix4fv(glGetUniformLocation(mainProgram, "model"), 1, GL_FALSE, &particleModel[0][0]);
-                glBindVertexArray(sphereVAO);
-                glDrawArrays(GL_TRIANGLES, 0, sphereVertexCount);
-            }
-
-			// Partículas de velocidade
-            for (const auto& particle : speedParticles) {
-                glUniform3fv(glGetUniformLocation(mainProgram, "objectColor"), 1, &particle.color[0]);
-                glUniform1f(glGetUniformLocation(mainProgram, "brightness"), 1.5f * particle.lifetime);
-
-                glm::mat4 particleModel = glm::translate(glm::mat4(1.0f), particle.position);
-                particleModel = glm::scale(particleModel, glm::vec3(particle.size));
-
-                glUniformMatrix4fv(glGetUniformLocation(mainProgram, "model"), 1, GL_FALSE, &particleModel[0][0]);
-                glBindVertexArray(sphereVAO);
-                glDrawArrays(GL_TRIANGLES, 0, sphereVertexCount);
-            }
-
-			// Moedas coletadas (particulas de coleta)
-            for (const auto& particle : collectParticles) {
-                glm::vec3 color = glm::vec3(1.0f, 0.84f, 0.0f);
-                glUniform3fv(glGetUniformLocation(mainProgram, "objectColor"), 1, &color[0]);
-                glUniform1f(glGetUniformLocation(mainProgram, "brightness"), 3.0f * particle.lifetime);
-
-                glm::mat4 particleModel = glm::translate(glm::mat4(1.0f), particle.position);
-                particleModel = glm::scale(particleModel, glm::vec3(particle.size));
-
-                glUniformMatrix4fv(glGetUniformLocation(mainProgram, "model"), 1, GL_FALSE, &particleModel[0][0]);
-                glBindVertexArray(sphereVAO);
-                glDrawArrays(GL_TRIANGLES, 0, sphereVertexCount);
-            }
-
-			// Particulas de explosão
-            for (const auto& particle : explosionParticles) {
-                glUniform3fv(glGetUniformLocation(mainProgram, "objectColor"), 1, &particle.color[0]);
-                glUniform1f(glGetUniformLocation(mainProgram, "brightness"), 4.0f * particle.lifetime);
-
-                glm::mat4 particleModel = glm::translate(glm::mat4(1.0f), particle.position);
-                particleModel = glm::scale(particleModel, glm::vec3(particle.size));
-
-                glUniformMatrix4fv(glGetUniformLocation(mainProgram, "model"), 1, GL_FALSE, &particleModel[0][0]);
-                glBindVertexArray(sphereVAO);
-                glDrawArrays(GL_TRIANGLES, 0, sphereVertexCount);
-            }
+            queueOpaque(playerModel, playerMesh, glm::vec3(0.8f, 0.1f, 0.1f), 1.2f);
 
             // Aliens
-            for (const auto& obs : obstacles) {
+            for (const auto& obs : world.obstacles) {
                 if (obs.active) {
-                    glUniform3fv(glGetUniformLocation(mainProgram, "objectColor"), 1, &obs.color[0]);
-                    glUniform1f(glGetUniformLocation(mainProgram, "brightness"), 1.0f);
-
-                    glm::mat4 m = glm::translate(glm::mat4(1.0f), obs.position);
+                    glm::mat4 m = glm::translate(glm::mat4(1.0f), interpolatedPosition(obs, alpha));
                     m = glm::rotate(m, glm::radians(obs.rotation), glm::vec3(0.0f, 1.0f, 0.0f));
 
                     if (alienModelLoaded) {
                         m = glm::scale(m, obs.scale * ALIEN_SCALE);
-                        glUniformMatrix4fv(glGetUniformLocation(mainProgram, "model"), 1, GL_FALSE, &m[0][0]);
-                        glBindVertexArray(alienVAO);
-                        glDrawArrays(GL_TRIANGLES, 0, alienVertexCount);
+                        queueOpaque(m, alienMesh, obs.color, 1.0f);
                     }
                     else {
                         m = glm::scale(m, obs.scale * 0.8f);
-                        glUniformMatrix4fv(glGetUniformLocation(mainProgram, "model"), 1, GL_FALSE, &m[0][0]);
-                        glBindVertexArray(cubeVAO);
-                        glDrawArrays(GL_TRIANGLES, 0, cubeVertexCount);
+                        queueOpaque(m, cubeMesh, obs.color, 1.0f);
                     }
                 }
             }
 
             // Bitcoins
-            for (const auto& col : collectibles) {
+            for (const auto& col : world.collectibles) {
                 if (col.active) {
                     float glowIntensity = 3.5f + sin(currentTime * 5.0f) * 1.2f;
-
                     glm::vec3 goldColor = glm::vec3(1.0f, 0.85f, 0.1f);
-                    glUniform3fv(glGetUniformLocation(mainProgram, "objectColor"), 1, &goldColor[0]);
-                    glUniform1f(glGetUniformLocation(mainProgram, "brightness"), glowIntensity);
 
-                    glm::mat4 m = glm::translate(glm::mat4(1.0f), col.position);
+                    glm::mat4 m = glm::translate(glm::mat4(1.0f), interpolatedPosition(col, alpha));
                     m = glm::rotate(m, currentTime * 3.0f, glm::vec3(0.0f, 1.0f, 0.0f));
 
                     if (bitcoinModelLoaded) {
                         m = glm::scale(m, glm::vec3(BITCOIN_SCALE));
-                        glUniformMatrix4fv(glGetUniformLocation(mainProgram, "model"), 1, GL_FALSE, &m[0][0]);
-                        glBindVertexArray(bitcoinVAO);
-                        glDrawArrays(GL_TRIANGLES, 0, bitcoinVertexCount);
+                        queueOpaque(m, bitcoinMesh, goldColor, glowIntensity);
                     }
                     else {
                         m = glm::scale(m, col.scale * 0.7f);
-                        glUniformMatrix4fv(glGetUniformLocation(mainProgram, "model"), 1, GL_FALSE, &m[0][0]);
-                        glBindVertexArray(sphereVAO);
-                        glDrawArrays(GL_TRIANGLES, 0, sphereVertexCount);
+                        queueOpaque(m, sphereMesh, goldColor, glowIntensity);
                     }
                 }
             }
         }
 
-        glUniform3f(glGetUniformLocation(mainProgram, "objectColor"), 1.0f, 1.0f, 0.2f);
-        glUniform1f(glGetUniformLocation(mainProgram, "brightness"), 2.0f);
         glm::mat4 sunModel = glm::scale(glm::translate(glm::mat4(1.0f), sunPos), glm::vec3(sunScale));
-        glUniformMatrix4fv(glGetUniformLocation(mainProgram, "model"), 1, GL_FALSE, &sunModel[0][0]);
-        glBindVertexArray(sphereVAO);
-        glDrawArrays(GL_TRIANGLES, 0, sphereVertexCount);
+        queueOpaque(sunModel, sphereMesh, glm::vec3(1.0f, 1.0f, 0.2f), 2.0f);
+
+        frameQueue.sort();
+
+		// Pré-passe opcional: só profundidade, depois cada pixel é sombreado uma vez (GL_EQUAL)
+        if (depthPrepass) {
+            glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+            frameQueue.submit(PASS_DEPTH);
+            glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+            glDepthFunc(GL_EQUAL);
+            glDepthMask(GL_FALSE);
+        }
+        shadedFragments.begin();
+        frameQueue.submit(PASS_OPAQUE);
+        shadedFragments.end();
+        if (depthPrepass) {
+            glDepthFunc(GL_LESS);
+            glDepthMask(GL_TRUE);
+        }
+
+		// Transparentes depois de todos os opacos
+        if (world.gameState == PLAYING) {
+			// Partículas do thruster (propulsor) ficam presas ao corpo do jogador: o model delas é o dele
+            glm::mat4 thrusterBase = glm::translate(glm::mat4(1.0f), renderPlayerPos);
+            thrusterBase = glm::rotate(thrusterBase, glm::radians(world.playerRotation), glm::vec3(0.0f, 1.0f, 0.0f));
+            thrusterBase = glm::rotate(thrusterBase, glm::radians(flyTilt), glm::vec3(1.0f, 0.0f, 0.0f));
+            struct ParticleDraw {
+                ParticlePool& pool;
+                glm::mat4 model;
+                float brightness;
+            };
+            ParticleDraw particleDraws[GPU_PARTICLE_SYSTEMS] = {
+                { world.thrusterParticles, thrusterBase, 2.5f },
+                { world.speedParticles, glm::mat4(1.0f), 1.5f },     // Velocidade e vento
+                { world.collectParticles, glm::mat4(1.0f), 3.0f },   // Moedas coletadas
+                { world.explosionParticles, glm::mat4(1.0f), 4.0f },
+            };
+
+			// Partículas: billboards instanciados, um desenho por sistema.
+			// Sem escrita de profundidade para as bordas suaves não recortarem umas às outras
+            particleProgram.use();
+            glDepthMask(GL_FALSE);
+            for (int i = 0; i < GPU_PARTICLE_SYSTEMS; ++i) {
+                setDrawUniforms(particleDraws[i].model, glm::vec3(1.0f), particleDraws[i].brightness);
+                if (gpuParticlesEnabled) drawGpuParticles(gpuParticles[i], quadMesh);
+                else drawParticlePool(particleDraws[i].pool, quadMesh);
+            }
+
+            glDepthMask(GL_TRUE);
+        }
 
         // ================== RENDERIZAÇÃO DA INTERFACE COM IMGUI ==================
         ImGui_ImplOpenGL3_NewFrame();
         ImGui_ImplGlfw_NewFrame();
         ImGui::NewFrame();
 
-        if (gameState == MENU) {
+        if (world.gameState == MENU) {
             ImGui::SetNextWindowPos(ImVec2(currentWidth / 2.0f - 350, currentHeight / 2.0f - 300));
             ImGui::SetNextWindowSize(ImVec2(700, 600));
             ImGui::Begin("Menu", nullptr, ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoCollapse);
@@ -1516,16 +2754,16 @@ void main() {
             ImGui::SetWindowFontScale(1.0f);
             ImGui::End();
         }
-        else if (gameState == PLAYING) {
+        else if (world.gameState == PLAYING) {
             ImGui::SetNextWindowPos(ImVec2(currentWidth - 250, 10));
             ImGui::SetNextWindowSize(ImVec2(240, 130));
             ImGui::Begin("HUD", nullptr, ImGuiWindowFlags_NoTitleBar | ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoMove);
             ImGui::SetWindowFontScale(1.5f);
-            ImGui::TextColored(ImVec4(1.0f, 0.84f, 0.0f, 1.0f), "SCORE: %d", score);
-            ImGui::TextColored(ImVec4(0.7f, 0.7f, 1.0f, 1.0f), "RECORDE: %d", highScore);
+            ImGui::TextColored(ImVec4(1.0f, 0.84f, 0.0f, 1.0f), "SCORE: %d", world.score);
+            ImGui::TextColored(ImVec4(0.7f, 0.7f, 1.0f, 1.0f), "RECORDE: %d", world.highScore);
             ImGui::SetWindowFontScale(1.0f);
             ImGui::Spacing();
-            float speedPercent = ((gameSpeed - 0.12f) / 0.12f) * 100.0f;
+            float speedPercent = ((world.gameSpeed - GAME_SPEED_START) / GAME_SPEED_START) * 100.0f;
             ImGui::ProgressBar(speedPercent / 200.0f, ImVec2(-1, 0), "");
             ImGui::Text("Velocidade: %.0f%%", 100.0f + speedPercent);
             ImGui::End();
@@ -1539,8 +2777,29 @@ void main() {
             ImGui::SliderFloat("Z", &sunPos.z, -50.0f, 50.0f);
             ImGui::SliderFloat("Tamanho", &sunScale, 0.5f, 5.0f);
             ImGui::End();
+
+            ImGui::SetNextWindowPos(ImVec2(10, 160));
+            ImGui::SetNextWindowSize(ImVec2(300, 280));
+            ImGui::Begin("Desempenho", nullptr, ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoMove);
+            ImGui::Text("Frame: %.2f ms", frameStats.recentFrameMs);
+            int particleCount = 0;
+            for (int i = 0; i < GPU_PARTICLE_SYSTEMS; ++i) particleCount += gpuParticlesEnabled ? gpuParticles[i].used : 0;
+            particleCount += world.thrusterParticles.count + world.speedParticles.count +
+                             world.collectParticles.count + world.explosionParticles.count;
+            ImGui::Text(gpuParticlesEnabled ? "Aliens: %d, slots de particulas: %d" : "Aliens: %d, particulas: %d",
+                static_cast<int>(world.obstacles.size()), particleCount);
+            if (ImGui::Checkbox("Particulas na GPU", &gpuParticlesEnabled)) setExternalParticles(world, gpuParticlesEnabled);
+            ImGui::Text("Culling (visiveis / descartados):");
+            ImGui::Text("Camera:     %d / %d", cameraCull.visible, cameraCull.culled);
+            ImGui::Text("Sombra (%d): %d / %d", shadowCascades, shadowCull.visible, shadowCull.culled);
+            ImGui::Text("Cascatas estaticas refeitas: %d", staticShadows.rebuilds);
+            ImGui::Checkbox("Pre-passe de profundidade", &depthPrepass);
+            ImGui::Checkbox("Ordenar opacos (frente para tras)", &sortOpaque);
+            ImGui::Text("Fragmentos sombreados: %.2f M", shadedFragments.samples / 1.0e6f);
+            ImGui::Text("Programas: %d, VAOs: %d, desenhos: %d", renderStats.programBinds, renderStats.vaoBinds, renderStats.draws);
+            ImGui::End();
         }
-        else if (gameState == GAME_OVER) {
+        else if (world.gameState == GAME_OVER) {
             ImGui::SetNextWindowPos(ImVec2(currentWidth / 2.0f - 250, currentHeight / 2.0f - 200));
             ImGui::SetNextWindowSize(ImVec2(500, 400));
             ImGui::Begin("Game Over", nullptr, ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoCollapse);
@@ -1553,8 +2812,8 @@ void main() {
             ImGui::Spacing(); ImGui::Spacing();
 
             ImGui::SetWindowFontScale(1.8f);
-            ImGui::TextColored(ImVec4(1.0f, 0.84f, 0.0f, 1.0f), "Pontuacao: %d", score);
-            ImGui::TextColored(ImVec4(0.7f, 0.7f, 1.0f, 1.0f), "Recorde: %d", highScore);
+            ImGui::TextColored(ImVec4(1.0f, 0.84f, 0.0f, 1.0f), "Pontuacao: %d", world.score);
+            ImGui::TextColored(ImVec4(0.7f, 0.7f, 1.0f, 1.0f), "Recorde: %d", world.highScore);
             ImGui::SetWindowFontScale(1.0f);
             ImGui::Spacing(); ImGui::Spacing();
             ImGui::Separator();
@@ -1572,34 +2831,51 @@ void main() {
 
         glfwSwapBuffers(window);
         glfwPollEvents();
+
+#ifndef NDEBUG
+        unsigned long frameAllocations = heapAllocations.load(std::memory_order_relaxed) - allocationsBefore;
+        if (++frameIndex > ALLOCATION_WARMUP_FRAMES && frameAllocations > 0) {
+            std::cerr << "Frame " << frameIndex << ": " << frameAllocations << " alocacoes no loop principal\n";
+            assert(frameAllocations == 0);
+        }
+#endif
     }
 
+    if (options.stress) frameStats.report(std::cout);
+
     // ================== LIMPEZA FINAL ==================
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplGlfw_Shutdown();
     ImGui::DestroyContext();
 
     // Libera buffers e recursos OpenGL
-    glDeleteVertexArrays(1, &playerVAO);
-    glDeleteBuffers(1, &playerVBO);
-    glDeleteVertexArrays(1, &cubeVAO);
-    glDeleteBuffers(1, &cubeVBO);
-    glDeleteVertexArrays(1, &sphereVAO);
-    glDeleteBuffers(1, &sphereVBO);
-    glDeleteVertexArrays(1, &groundVAO);
-    glDeleteBuffers(1, &groundVBO);
-    if (alienModelLoaded) {
-        glDeleteVertexArrays(1, &alienVAO);
-        glDeleteBuffers(1, &alienVBO);
-    }
-    if (bitcoinModelLoaded) {
-        glDeleteVertexArrays(1, &bitcoinVAO);
-        glDeleteBuffers(1, &bitcoinVBO);
-    }
-    glDeleteProgram(mainProgram);
-    glDeleteProgram(depthProgram);
+    deleteMesh(playerMesh);
+    deleteMesh(cubeMesh);
+    deleteMesh(sphereMesh);
+    deleteMesh(groundMesh);
+    deleteMesh(quadMesh);
+    deleteMesh(alienMesh);
+    deleteMesh(bitcoinMesh);
+    for (int i = 0; i < 5; ++i) deleteMesh(cloudMesh[i]);
+    deleteMesh(treeMesh);
+    deleteInstancedMesh(treeShadowInstances);
+    deleteInstancedMesh(treeCameraInstances);
+    glDeleteVertexArrays(1, &particleVAO);
+    glDeleteBuffers(PARTICLE_BUFFER_COUNT, particleInstanceVBOs);
+    for (auto& system : gpuParticles) deleteGpuParticleSystem(system);
+    glDeleteProgram(particleUpdateProgram.id);
+    glDeleteProgram(mainProgram.id);
+    glDeleteProgram(mainInstancedProgram.id);
+    glDeleteProgram(depthInstancedProgram.id);
+    glDeleteProgram(particleProgram.id);
+    glDeleteBuffers(1, &frameUBO);
+    glDeleteBuffers(1, &drawUBO);
+    glDeleteProgram(depthProgram.id);
     glDeleteFramebuffers(1, &depthMapFBO);
     glDeleteTextures(1, &depthMap);
+    glDeleteFramebuffers(1, &staticShadows.fbo);
+    glDeleteTextures(1, &staticShadows.depthMap);
+    glDeleteQueries(FRAGMENT_QUERIES, shadedFragments.queries);
     glfwTerminate();
 
     return 0;